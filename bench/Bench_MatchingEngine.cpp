@@ -0,0 +1,150 @@
+#include    "OrderFlow.h"
+
+#include    <MatchingEngine.h>
+#include    <EngineStats.h>
+#include    <Order.h>
+
+#include    <benchmark/benchmark.h>
+
+#include    <array>
+#include    <chrono>
+#include    <cstddef>
+#include    <cstdint>
+#include    <memory>
+#include    <string>
+#include    <type_traits>
+
+namespace {
+    using namespace pentifica::trd;
+    using namespace pentifica::trd::exch;
+
+    using FlowOrder = OrderFlow::Order;
+    using BaselineOrder = Order<std::int64_t>;
+    using Histogram = LatencyHistogram<>;
+    constexpr std::uint64_t seed{20231017};
+
+    /// @brief Reports orders filled in full back to the flow
+    struct FlowCallback {
+        template<typename OrderDef, typename OrderRef>
+        void operator()(EngineOnTrade<OrderDef, OrderRef> const& info) const {
+            if(info.existing_order_->Quantity() == 0) flow_->Gone(info.existing_order_->Key());
+            if(info.new_order_->Quantity() == 0) flow_->Gone(info.new_order_->Key());
+        }
+        void operator()(auto const&) const {}
+
+        OrderFlow* flow_{};
+    };
+
+    struct MapConfig : EngineConfig {
+        using Orders = PooledOrders<4096, PoolExhaustion::GROW>;
+        using Keys = IntegerKeys<4096>;
+        static constexpr std::size_t entry_slab_size{4096};
+    };
+    struct TickConfig : MapConfig {
+        using Ladders = TickLadders<1 << 16>;
+    };
+    /// @brief Latencies of each kind of flow event
+    struct Latencies {
+        static constexpr std::array<FlowAction, 5> actions{
+            FlowAction::ADD, FlowAction::MARKET, FlowAction::IOC, FlowAction::CANCEL, FlowAction::REVISE};
+
+        static std::size_t Slot(FlowAction action) {
+            return static_cast<std::size_t>(std::find(actions.begin(), actions.end(), action) - actions.begin());
+        }
+        static std::string Name(FlowAction action) {
+            switch(action) {
+                case FlowAction::ADD:       return "add";
+                case FlowAction::MARKET:    return "market";
+                case FlowAction::IOC:       return "ioc";
+                case FlowAction::CANCEL:    return "cancel";
+                case FlowAction::REVISE:    return "revise";
+            }
+            return "unknown";
+        }
+
+        std::array<Histogram, actions.size()> histograms_{};
+    };
+    /// @brief  A flow order as an engine's order type. An Order is given
+    ///         its key as its string identifier, for IdKeys.
+    template<typename OrderDef>
+    OrderDef Convert(FlowOrder const& order) {
+        if constexpr(std::is_same_v<OrderDef, FlowOrder>) {
+            return order;
+        }
+        else {
+            OrderDef converted(order.Side(), order.Type(), order.TIF(), order.Price(), order.Quantity(),
+                std::to_string(order.Key()), {});
+            converted.Key(order.Key());
+            return converted;
+        }
+    }
+    /// @brief Apply a flow event, its order converted up front, to an engine
+    template<typename Config, typename Engine, typename OrderDef>
+    void Apply(Engine& engine, FlowAction action, OrderDef const& order) {
+        switch(action) {
+            case FlowAction::CANCEL:
+                engine.Cancel(Config::Keys::Key(order));
+                return;
+            case FlowAction::REVISE:
+                engine.Revise(order);
+                return;
+            default:
+                if(order.Side() == OrderSide::BUY)  engine.Buy(order);
+                else                                engine.Sell(order);
+                return;
+        }
+    }
+    /// @brief  Run an order flow against a book holding state.range(0)
+    ///         resting orders. Each iteration times one event; the time
+    ///         spent generating and converting it is excluded.
+    template<typename OrderDef, typename Config>
+    void BM_OrderFlow(benchmark::State& state) {
+        using Engine = MatchingEngine<OrderDef, FlowCallback, Config>;
+        auto const depth{static_cast<std::size_t>(state.range(0))};
+
+        OrderFlowMix mix;
+        //  spread deep books over more levels
+        mix.mean_distance_ = std::max(mix.mean_distance_, static_cast<double>(depth) / 10'000.0);
+        OrderFlow flow{mix, seed, depth};
+        auto engine{std::make_unique<Engine>(FlowCallback{&flow})};
+        while(flow.Live() < depth) {
+            auto const event{flow.Passive()};
+            Apply<Config>(*engine, event.action_, Convert<OrderDef>(event.order_));
+        }
+
+        auto latencies{std::make_unique<Latencies>()};
+        std::uint64_t events{};
+        for(auto _ : state) {
+            auto const event{flow.Next()};
+            auto const order{Convert<OrderDef>(event.order_)};
+            auto const start{std::chrono::steady_clock::now()};
+            Apply<Config>(*engine, event.action_, order);
+            auto const elapsed{std::chrono::duration<double>(std::chrono::steady_clock::now() - start)};
+            state.SetIterationTime(elapsed.count());
+            latencies->histograms_[Latencies::Slot(event.action_)].Record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            ++events;
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(events));
+        state.counters["resting"] = static_cast<double>(engine->Resting());
+        for(auto action : Latencies::actions) {
+            auto const snapshot{latencies->histograms_[Latencies::Slot(action)].Take()};
+            if(snapshot.count_ == 0) continue;
+            auto const name{Latencies::Name(action)};
+            state.counters[name + "_p50_ns"] = static_cast<double>(Histogram::ValueAt(snapshot, 50.0));
+            state.counters[name + "_p99_ns"] = static_cast<double>(Histogram::ValueAt(snapshot, 99.0));
+            state.counters[name + "_p99.9_ns"] = static_cast<double>(Histogram::ValueAt(snapshot, 99.9));
+        }
+    }
+}
+
+//  the default engine: map ladders, shared orders and string keys
+BENCHMARK(BM_OrderFlow<BaselineOrder, EngineConfig>)->Name("OrderFlow/Baseline")
+    ->RangeMultiplier(10)->Range(10, 1'000'000)->UseManualTime();
+BENCHMARK(BM_OrderFlow<FlowOrder, MapConfig>)->Name("OrderFlow/MapLadders")
+    ->RangeMultiplier(10)->Range(10, 1'000'000)->UseManualTime();
+BENCHMARK(BM_OrderFlow<FlowOrder, TickConfig>)->Name("OrderFlow/TickLadders")
+    ->RangeMultiplier(10)->Range(10, 1'000'000)->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,177 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <CompactOrder.h>
+#include    <FlatHashMap.h>
+
+#include    <algorithm>
+#include    <cstddef>
+#include    <cstdint>
+#include    <random>
+#include    <vector>
+
+namespace pentifica::trd::exch {
+/// @brief The shape of a synthetic order flow
+struct OrderFlowMix {
+    /// @brief Relative weights of new orders, cancels and revisions
+    double add_{0.45};
+    double cancel_{0.40};
+    double revise_{0.15};
+    /// @brief The fractions of new orders that are market and IOC orders
+    double market_{0.02};
+    double ioc_{0.08};
+    /// @brief The fraction of IOC orders priced through the touch
+    double aggressive_{0.5};
+    /// @brief The mean distance, in ticks, of a resting order from the touch
+    double mean_distance_{4.0};
+    /// @brief The chance of each event moving the mid price by one tick
+    double drift_{0.01};
+    /// @brief The range order quantities are drawn from
+    std::size_t min_quantity_{1};
+    std::size_t max_quantity_{100};
+    /// @brief The mid price, in ticks, the flow starts at
+    std::int64_t mid_{100'000};
+};
+/// @brief The operations a flow event asks of an engine
+enum class FlowAction:char {ADD = 'A', MARKET = 'M', IOC = 'I', CANCEL = 'C', REVISE = 'R'};
+/// @brief One step of a synthetic order flow
+struct FlowEvent {
+    FlowAction action_{FlowAction::ADD};
+    CompactOrder<std::int64_t> order_{};
+};
+/// @brief  A seeded generator of a realistic order flow: new orders resting
+///         at a geometrically distributed distance from a drifting mid,
+///         market and IOC orders, and cancels and revisions of orders it
+///         believes rest. The engine's callback reports orders filled in
+///         full through Gone, keeping that belief current. While fewer than
+///         the target depth rest, cancels give way to new orders, so the
+///         book holds its depth as fills consume it. Orders are keyed
+///         by 64 bit keys, as with IntegerKeys. The same seed and mix always
+///         yield the same flow against the same engine.
+class OrderFlow {
+public:
+    using Order = CompactOrder<std::int64_t>;
+
+    /// @brief Prepare a flow
+    /// @param mix The shape of the flow
+    /// @param seed Seeds the flow's random numbers
+    /// @param depth The number of resting orders the flow keeps the book near
+    explicit OrderFlow(OrderFlowMix const& mix, std::uint64_t seed, std::size_t depth) :
+        mix_{mix},
+        depth_{depth},
+        random_{seed},
+        action_{{mix.add_, mix.cancel_, mix.revise_}},
+        distance_{1.0 / (1.0 + std::max(mix.mean_distance_, 0.0))},
+        quantity_{mix.min_quantity_, std::max(mix.min_quantity_, mix.max_quantity_)},
+        mid_{mix.mid_} {}
+    /// @brief Returns a new order that rests away from the touch
+    FlowEvent Passive() {
+        auto const side{Coin(0.5) ? OrderSide::BUY : OrderSide::SELL};
+        auto const distance{static_cast<std::int64_t>(distance_(random_)) + 1};
+        auto const price{side == OrderSide::BUY ? mid_ - distance : mid_ + distance};
+        auto order{Make(side, OrderType::LIMIT, OrderTimeInForce::DAY, price, quantity_(random_))};
+        Rest(order);
+        return {FlowAction::ADD, order};
+    }
+    /// @brief Returns the next event of the flow
+    FlowEvent Next() {
+        if(Coin(mix_.drift_)) mid_ += Coin(0.5) ? 1 : -1;
+
+        auto action{action_(random_)};
+        if(live_.empty() || (action == 1 && live_.size() < depth_)) action = 0;
+        switch(action) {
+            case 1:     return Cancel();
+            case 2:     return Revise();
+            default:    return Add();
+        }
+    }
+    /// @brief The order with a key has left the book
+    void Gone(std::uint64_t key) {
+        auto* position{positions_.Find(key)};
+        if(!position) return;
+        auto const index{*position};
+        positions_.Erase(key);
+        if(index + 1 != live_.size()) {
+            live_[index] = live_.back();
+            *positions_.Find(live_[index].Key()) = index;
+        }
+        live_.pop_back();
+    }
+    /// @brief Returns the number of orders the flow believes rest
+    std::size_t Live() const { return live_.size(); }
+
+private:
+    bool Coin(double probability) { return std::bernoulli_distribution{probability}(random_); }
+    Order Make(OrderSide side, OrderType type, OrderTimeInForce tif, std::int64_t price, std::size_t quantity) {
+        Order order(side, type, tif, price, quantity, {}, {});
+        order.Key(++key_);
+        return order;
+    }
+    void Rest(Order const& order) {
+        *positions_.TryEmplace(order.Key()).first = live_.size();
+        live_.push_back(order);
+    }
+    FlowEvent Add() {
+        auto const kind{std::uniform_real_distribution<>{}(random_)};
+        if(kind >= mix_.market_ + mix_.ioc_) return Passive();
+
+        auto const side{Coin(0.5) ? OrderSide::BUY : OrderSide::SELL};
+        if(kind < mix_.market_) {
+            return {FlowAction::MARKET, Make(side, OrderType::MARKET, OrderTimeInForce::IOC, 0, quantity_(random_))};
+        }
+        //  an IOC reaches through the touch or stops short of it
+        auto const reach{static_cast<std::int64_t>(distance_(random_)) + 1};
+        auto const through{Coin(mix_.aggressive_) ? reach : -reach};
+        auto const price{side == OrderSide::BUY ? mid_ + through : mid_ - through};
+        return {FlowAction::IOC, Make(side, OrderType::LIMIT, OrderTimeInForce::IOC, price, quantity_(random_))};
+    }
+    FlowEvent Cancel() {
+        auto const order{Pick()};
+        Gone(order.Key());
+        return {FlowAction::CANCEL, order};
+    }
+    /// @brief Halve an order's quantity, keeping its place, or move it a tick
+    FlowEvent Revise() {
+        auto& order{live_[std::uniform_int_distribution<std::size_t>{0, live_.size() - 1}(random_)]};
+        if(order.Quantity() > 1 && Coin(0.5)) {
+            order.Quantity(order.Quantity() / 2);
+        }
+        else {
+            auto const away{order.Side() == OrderSide::BUY ? -1 : 1};
+            order.Price(order.Price() + (Coin(0.5) ? away : -away));
+        }
+        return {FlowAction::REVISE, order};
+    }
+    Order const& Pick() {
+        return live_[std::uniform_int_distribution<std::size_t>{0, live_.size() - 1}(random_)];
+    }
+
+    OrderFlowMix const mix_;
+    std::size_t const depth_;
+    std::mt19937_64 random_;
+    std::discrete_distribution<int> action_;
+    std::geometric_distribution<std::int64_t> distance_;
+    std::uniform_int_distribution<std::size_t> quantity_;
+    std::int64_t mid_;
+    std::uint64_t key_{};
+    std::vector<Order> live_{};
+    FlatHashMap<std::uint64_t, std::size_t> positions_{};
+};
+}
@@ -0,0 +1,83 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <compare>
+#include    <concepts>
+#include    <cmath>
+#include    <cstdint>
+#include    <type_traits>
+
+namespace pentifica::trd {
+/// @brief  A fixed point price held as an integer count of ticks of
+///         10^-Decimals. Comparison and tick arithmetic are single integer
+///         operations, and a price converts explicitly to its tick count so
+///         it can index dense price ladders.
+/// @tparam Decimals    The number of decimal places a tick represents
+/// @tparam Rep         The signed integer tick count type
+template<unsigned Decimals, std::signed_integral Rep = std::int64_t>
+class TickPrice {
+    static constexpr Rep Power(unsigned exponent) { return exponent ? 10 * Power(exponent - 1) : 1; }
+public:
+    using RepType = Rep;
+    static constexpr unsigned decimals{Decimals};
+    /// @brief The number of ticks in one whole unit of price
+    static constexpr Rep scale{Power(Decimals)};
+
+    constexpr TickPrice() = default;
+    /// @brief Initialize from a tick count
+    constexpr explicit TickPrice(Rep ticks) : ticks_{ticks} {}
+    /// @brief Returns the price nearest a floating point value
+    static TickPrice FromDouble(double value) {
+        return TickPrice{static_cast<Rep>(std::llround(value * static_cast<double>(scale)))};
+    }
+
+    constexpr Rep Ticks() const { return ticks_; }
+    double ToDouble() const { return static_cast<double>(ticks_) / static_cast<double>(scale); }
+    constexpr explicit operator Rep() const { return ticks_; }
+
+    constexpr TickPrice& operator+=(TickPrice other) { ticks_ += other.ticks_; return *this; }
+    constexpr TickPrice& operator-=(TickPrice other) { ticks_ -= other.ticks_; return *this; }
+    constexpr TickPrice& operator++() { ++ticks_; return *this; }
+    constexpr TickPrice& operator--() { --ticks_; return *this; }
+    friend constexpr TickPrice operator+(TickPrice lhs, TickPrice rhs) { return TickPrice{lhs.ticks_ + rhs.ticks_}; }
+    friend constexpr TickPrice operator-(TickPrice lhs, TickPrice rhs) { return TickPrice{lhs.ticks_ - rhs.ticks_}; }
+    /// @brief Offset a price by a number of ticks
+    friend constexpr TickPrice operator+(TickPrice lhs, Rep ticks) { return TickPrice{lhs.ticks_ + ticks}; }
+    friend constexpr TickPrice operator-(TickPrice lhs, Rep ticks) { return TickPrice{lhs.ticks_ - ticks}; }
+    friend constexpr bool operator==(TickPrice, TickPrice) = default;
+    friend constexpr auto operator<=>(TickPrice, TickPrice) = default;
+
+private:
+    Rep ticks_{};
+};
+/// @brief Identifies a @ref TickPrice
+template<typename T> struct IsTickPrice : std::false_type {};
+template<unsigned Decimals, std::signed_integral Rep>
+struct IsTickPrice<TickPrice<Decimals, Rep>> : std::true_type {};
+template<typename T>
+inline constexpr bool is_tick_price_v{IsTickPrice<T>::value};
+/// @brief Returns the tick count of a price that is either a plain integral
+///        tick count or a @ref TickPrice
+template<typename PriceType>
+constexpr auto TicksOf(PriceType price) {
+    if constexpr(is_tick_price_v<PriceType>)    return price.Ticks();
+    else                                        return price;
+}
+}
@@ -0,0 +1,168 @@
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    "TscClock.h"
+
+#include    <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include    <cpuid.h>
+#endif
+
+namespace pentifica::trd {
+    namespace {
+        constexpr std::int64_t nanoseconds_per_second{1'000'000'000};
+        /// @brief How long the counter is measured against the wall clock
+        constexpr std::int64_t calibration_nanoseconds{10'000'000};
+        /// @brief The plausible range of counter rates, in ticks per second
+        constexpr std::uint64_t min_frequency{100'000'000};
+        constexpr std::uint64_t max_frequency{10'000'000'000};
+
+        std::int64_t Realtime() {
+            timespec now;
+            clock_gettime(CLOCK_REALTIME, &now);
+            return now.tv_sec * nanoseconds_per_second + now.tv_nsec;
+        }
+        bool InvariantTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+            unsigned eax{}, ebx{}, ecx{}, edx{};
+            if(!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return false;
+            return (edx & (1u << 8)) != 0;
+#else
+            return false;
+#endif
+        }
+        /// @brief  A counter reading and the wall clock time between two
+        ///         counter readings, taken from the tightest of a few tries
+        struct Sample {
+            std::uint64_t ticks_{};
+            std::int64_t nanoseconds_{};
+        };
+        Sample Take() {
+            Sample best;
+#if defined(__x86_64__) || defined(__i386__)
+            auto narrowest{~std::uint64_t{}};
+            for(int attempt = 0; attempt < 5; ++attempt) {
+                auto const before{__rdtsc()};
+                auto const nanoseconds{Realtime()};
+                auto const after{__rdtsc()};
+                if(after - before < narrowest) {
+                    narrowest = after - before;
+                    best = {before + (after - before) / 2, nanoseconds};
+                }
+            }
+#endif
+            return best;
+        }
+        /// @brief Returns nanoseconds per tick as a 32.32 fixed point number
+        std::uint64_t Scale(std::uint64_t ticks, std::int64_t nanoseconds) {
+            return static_cast<std::uint64_t>((static_cast<unsigned __int128>(nanoseconds) << 32) / ticks);
+        }
+        /// @brief  Where the current rate measurement started. Only touched
+        ///         while holding the anchor's sequence lock.
+        Sample origin{};
+        /// @brief  Calibrates the clock during process startup. Linked in by
+        ///         any use of the clock, since now reaches this file.
+        [[maybe_unused]] bool const calibrated{TscClock::CalibrateOnce()};
+    }
+
+    bool
+    TscClock::Calibrate() noexcept {
+        if(!InvariantTsc()) {
+            Disable();
+            return false;
+        }
+        auto const start{Take()};
+        while(Realtime() - start.nanoseconds_ < calibration_nanoseconds) {}
+        auto const end{Take()};
+
+        auto const ticks{end.ticks_ - start.ticks_};
+        auto const nanoseconds{end.nanoseconds_ - start.nanoseconds_};
+        if(end.ticks_ <= start.ticks_ || nanoseconds <= 0) {
+            Disable();
+            return false;
+        }
+        auto const frequency{static_cast<std::uint64_t>(
+            static_cast<unsigned __int128>(ticks) * nanoseconds_per_second / static_cast<std::uint64_t>(nanoseconds))};
+        if(frequency < min_frequency || frequency > max_frequency) {
+            Disable();
+            return false;
+        }
+
+        auto sequence{sequence_.load(std::memory_order_relaxed)};
+        do {
+            sequence &= ~std::uint32_t{1};
+        } while(!sequence_.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire));
+        std::atomic_thread_fence(std::memory_order_release);
+        origin = start;
+        ticks_.store(end.ticks_, std::memory_order_relaxed);
+        nanoseconds_.store(end.nanoseconds_, std::memory_order_relaxed);
+        scale_.store(Scale(ticks, nanoseconds), std::memory_order_relaxed);
+        resync_ticks_.store(frequency * static_cast<std::uint64_t>(resync_interval.count()), std::memory_order_relaxed);
+        sequence_.store(sequence + 2, std::memory_order_release);
+
+        mode_.store(Mode::TSC, std::memory_order_release);
+        return true;
+    }
+    std::uint64_t
+    TscClock::Frequency() noexcept {
+        Anchor anchor;
+        if(!UsesTsc() || !Read(anchor) || anchor.scale_ == 0) return 0;
+        return static_cast<std::uint64_t>(
+            (static_cast<unsigned __int128>(nanoseconds_per_second) << 32) / anchor.scale_);
+    }
+    TscClock::time_point
+    TscClock::Resync() noexcept {
+        auto sequence{sequence_.load(std::memory_order_relaxed)};
+        if((sequence & 1) ||
+            !sequence_.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire)) {
+            //  another thread is re-anchoring
+            return Wall();
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Anchor const anchor{ticks_.load(std::memory_order_relaxed), nanoseconds_.load(std::memory_order_relaxed),
+            scale_.load(std::memory_order_relaxed), resync_ticks_.load(std::memory_order_relaxed)};
+        auto const now{Take()};
+        if(now.ticks_ <= anchor.ticks_) {
+            //  the counter stalled or ran backwards
+            Disable();
+            sequence_.store(sequence + 2, std::memory_order_release);
+            return TimeAt(now.nanoseconds_);
+        }
+
+        auto const drift{anchor.At(now.ticks_) - TimeAt(now.nanoseconds_)};
+        if(drift > max_drift || drift < -max_drift || now.nanoseconds_ <= origin.nanoseconds_) {
+            //  the wall clock was stepped: measure the rate afresh from here
+            origin = now;
+        }
+        else {
+            scale_.store(Scale(now.ticks_ - origin.ticks_, now.nanoseconds_ - origin.nanoseconds_),
+                std::memory_order_relaxed);
+        }
+        ticks_.store(now.ticks_, std::memory_order_relaxed);
+        nanoseconds_.store(now.nanoseconds_, std::memory_order_relaxed);
+        sequence_.store(sequence + 2, std::memory_order_release);
+        return TimeAt(now.nanoseconds_);
+    }
+    TscClock::time_point
+    TscClock::Wall() noexcept {
+        return TimeAt(Realtime());
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <atomic>
+#include    <chrono>
+#include    <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include    <x86intrin.h>
+#endif
+
+namespace pentifica::trd {
+/// @brief  A wall clock read from the invariant time stamp counter. The
+///         counter is calibrated against CLOCK_REALTIME, which takes about
+///         10ms, once during process startup, before main, so neither the
+///         first order nor the first message pays for it; time read before
+///         then comes from clock_gettime. It is re-anchored to
+///         the wall clock every resync_interval, refining the rate over the
+///         whole interval since calibration, so reading the time costs a
+///         counter read and a multiply instead of a system call. When the
+///         processor lacks an invariant counter, the calibrated rate is
+///         implausible or the counter is seen to stall or run backwards, the
+///         clock falls back to clock_gettime for good. A wall clock step
+///         larger than max_drift is followed at the next resync and restarts
+///         the rate measurement.
+///
+///         Time points are those of std::chrono::system_clock, so the clock
+///         replaces it without changing any stored time.
+class TscClock {
+public:
+    using duration = std::chrono::system_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::system_clock::time_point;
+    static constexpr bool is_steady{false};
+    /// @brief How often the counter is re-anchored to the wall clock
+    static constexpr std::chrono::seconds resync_interval{1};
+    /// @brief The largest disagreement with the wall clock at a resync
+    ///        still taken as counter drift rather than a wall clock step
+    static constexpr std::chrono::microseconds max_drift{100};
+
+    /// @brief Returns the current time
+    static time_point now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        if(mode_.load(std::memory_order_acquire) == Mode::TSC) {
+            auto const ticks{__rdtsc()};
+            Anchor anchor;
+            if(Read(anchor) && ticks - anchor.ticks_ < anchor.resync_ticks_) return anchor.At(ticks);
+            return Resync();
+        }
+#endif
+        return Wall();
+    }
+    /// @brief  Measure the counter rate against the wall clock and start
+    ///         reading time from the counter, if it is usable. Calling it
+    ///         again recalibrates.
+    /// @return true if time is read from the counter
+    static bool Calibrate() noexcept;
+    /// @brief  Calibrate unless already calibrated or given up on, as is
+    ///         done during process startup
+    /// @return true if time is read from the counter
+    static bool CalibrateOnce() noexcept {
+        if(mode_.load(std::memory_order_acquire) == Mode::UNCALIBRATED) return Calibrate();
+        return UsesTsc();
+    }
+    /// @brief Read time from clock_gettime from now on
+    static void Disable() noexcept { mode_.store(Mode::WALL, std::memory_order_release); }
+    /// @brief Indicates if time is read from the counter
+    static bool UsesTsc() noexcept { return mode_.load(std::memory_order_acquire) == Mode::TSC; }
+    /// @brief Returns the calibrated counter rate in ticks per second; 0
+    ///        if time is not read from the counter
+    static std::uint64_t Frequency() noexcept;
+
+private:
+    enum class Mode:char {UNCALIBRATED = 'U', TSC = 'T', WALL = 'W'};
+    /// @brief  A counter reading paired with the wall clock time it stands
+    ///         for and the rate at which later readings advance from it
+    struct Anchor {
+        std::uint64_t ticks_{};
+        std::int64_t nanoseconds_{};
+        /// @brief Nanoseconds per tick as a 32.32 fixed point number
+        std::uint64_t scale_{};
+        std::uint64_t resync_ticks_{};
+
+        time_point At(std::uint64_t ticks) const {
+            auto const elapsed{static_cast<std::uint64_t>(
+                (static_cast<unsigned __int128>(ticks - ticks_) * scale_) >> 32)};
+            return TimeAt(nanoseconds_ + static_cast<std::int64_t>(elapsed));
+        }
+    };
+    /// @brief Returns the time a count of nanoseconds since the epoch stands
+    ///        for, in whatever resolution system_clock has
+    static time_point TimeAt(std::int64_t nanoseconds) noexcept {
+        return time_point{std::chrono::duration_cast<duration>(std::chrono::nanoseconds{nanoseconds})};
+    }
+    /// @brief Read the current anchor
+    /// @return false if it was being replaced
+    static bool Read(Anchor& anchor) noexcept {
+        auto const sequence{sequence_.load(std::memory_order_acquire)};
+        if(sequence & 1) return false;
+        anchor.ticks_ = ticks_.load(std::memory_order_relaxed);
+        anchor.nanoseconds_ = nanoseconds_.load(std::memory_order_relaxed);
+        anchor.scale_ = scale_.load(std::memory_order_relaxed);
+        anchor.resync_ticks_ = resync_ticks_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence_.load(std::memory_order_relaxed) == sequence;
+    }
+    /// @brief Re-anchor the counter to the wall clock, or give the counter
+    ///        up, and return the current time
+    static time_point Resync() noexcept;
+    /// @brief Returns the time from clock_gettime
+    static time_point Wall() noexcept;
+
+    //  The anchor is replaced under a sequence lock: odd while a resync
+    //  writes it, so readers never combine fields of two anchors
+    static inline std::atomic<Mode> mode_{Mode::UNCALIBRATED};
+    static inline std::atomic<std::uint32_t> sequence_{};
+    static inline std::atomic<std::uint64_t> ticks_{};
+    static inline std::atomic<std::int64_t> nanoseconds_{};
+    static inline std::atomic<std::uint64_t> scale_{};
+    static inline std::atomic<std::uint64_t> resync_ticks_{};
+};
+}
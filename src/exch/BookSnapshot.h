@@ -0,0 +1,138 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <Journal.h>
+#include    <MappedFile.h>
+
+#include    <cstddef>
+#include    <cstdint>
+#include    <cstring>
+#include    <filesystem>
+#include    <stdexcept>
+#include    <string>
+
+namespace pentifica::trd::exch {
+/// @brief  Saves the resting orders of a @ref MatchingEngine to a versioned
+///         binary file and loads them back. Orders are written bids then
+///         offers, best price first and in time priority within a price, so
+///         loading them in file order rebuilds every level's queue; pending
+///         stops follow in trigger order. Each order carries the quantity it
+///         displays, so an iceberg keeps what is left of its slice, and the
+///         header carries the last trade price and whether an auction is under
+///         way. Each snapshot records the journal sequence number it reflects;
+///         replay the journal after that number to bring a loaded book up to
+///         date.
+/// @tparam OrderDef The order type
+template<typename OrderDef>
+class BookSnapshot {
+public:
+    using PriceType = OrderDef::PriceType;
+    /// @brief A resting order along with the quantity it displays
+    struct Record {
+        JournalRecord<PriceType> order_;
+        std::uint64_t shown_;
+    };
+
+    static constexpr std::uint64_t magic{0x50414e5344525450};  //  "PTRDSNAP"
+    static constexpr std::uint32_t version{3};
+    static constexpr std::size_t header_size{64};
+
+    struct Header {
+        std::uint64_t magic_;
+        std::uint32_t version_;
+        std::uint32_t record_size_;
+        std::uint64_t count_;
+        /// @brief The journal sequence number the snapshot reflects
+        std::uint64_t sequence_;
+        /// @brief The price of the last trade, if has_last_price_ is set
+        PriceType last_price_;
+        std::uint8_t has_last_price_;
+        /// @brief Set if a call auction was under way
+        std::uint8_t auction_;
+    };
+    static_assert(sizeof(Header) <= header_size);
+    /// @brief Write a snapshot. The file is replaced only once the snapshot
+    ///        is complete and on disk.
+    /// @param engine The engine
+    /// @param path The snapshot file
+    /// @param sequence The journal sequence number the book reflects
+    /// @return The number of orders written
+    /// @throw std::system_error if the file cannot be written
+    template<typename Engine>
+    static std::size_t Save(Engine const& engine, std::string const& path, std::uint64_t sequence) {
+        auto const staging{path + ".tmp"};
+        std::filesystem::remove(staging);
+
+        auto const count{engine.Resting()};
+        {
+            MappedFile file{staging, MapMode::WRITE, header_size + count * sizeof(Record)};
+            auto const last_price{engine.LastPrice()};
+            Header const header{magic, version, sizeof(Record), count, sequence,
+                last_price.value_or(PriceType{}), last_price.has_value(), engine.InAuction()};
+            std::memcpy(file.Data(), &header, sizeof(header));
+
+            auto* next{file.Data() + header_size};
+            std::size_t written{};
+            engine.ForEachResting([&next, &written](OrderDef const& order, std::size_t shown) {
+                auto const action{order.Side() == OrderSide::BUY ? EngineAction::BUY : EngineAction::SELL};
+                Record const record{RecordOf(++written, action, order), shown};
+                std::memcpy(next, &record, sizeof(record));
+                next += sizeof(record);
+            });
+            if(written != count) throw std::logic_error("Snapshot order count mismatch");
+            file.Sync(0, file.Size(), true);
+        }
+        std::filesystem::rename(staging, path);
+        return count;
+    }
+    /// @brief Load a snapshot into an engine whose book is empty
+    /// @param engine The engine
+    /// @param path The snapshot file
+    /// @return The journal sequence number the snapshot reflects
+    /// @throw std::system_error if the file cannot be read
+    /// @throw std::runtime_error if the file is not a compatible snapshot or
+    ///        the engine's order store cannot hold it
+    template<typename Engine>
+    static std::uint64_t Load(Engine& engine, std::string const& path) {
+        MappedFile file{path, MapMode::READ};
+        Header header{};
+        if(file.Size() >= header_size) std::memcpy(&header, file.Data(), sizeof(header));
+        if(header.magic_ != magic || header.version_ != version || header.record_size_ != sizeof(Record)) {
+            throw std::runtime_error("Snapshot format mismatch");
+        }
+        if(header_size + header.count_ * sizeof(Record) > file.Size()) {
+            throw std::runtime_error("Snapshot truncated");
+        }
+        file.Sequential();
+
+        auto const* next{file.Data() + header_size};
+        for(std::uint64_t index = 0; index < header.count_; ++index, next += sizeof(Record)) {
+            Record record;
+            std::memcpy(&record, next, sizeof(record));
+            if(!engine.Restore(OrderOf<OrderDef>(record.order_), record.shown_)) {
+                throw std::runtime_error("Snapshot exceeds order store");
+            }
+        }
+        if(header.has_last_price_) engine.LastPrice(header.last_price_);
+        if(header.auction_) engine.BeginAuction();
+        return header.sequence_;
+    }
+};
+}
@@ -0,0 +1,115 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <FixedId.h>
+#include    <Order.h>
+#include    <Ring.h>
+
+#include    <chrono>
+#include    <cstddef>
+#include    <cstdint>
+#include    <string_view>
+
+namespace pentifica::trd::exch {
+/// @brief  An order with the interface of @ref Order laid out for matching.
+///         The fields the matcher reads and writes share the first cache
+///         line; the identifier, account, session and times are held inline
+///         at their FIX widths in the second. Matching against a resting
+///         order reads this first line and the line of its book entry that
+///         holds its rung links; the second line is read only once the order
+///         leaves the book. Time priority is an order's place in its rung, so
+///         it carries no sequence number. The order owns no heap storage and
+///         is trivially copyable.
+/// @tparam T   Specifies the data type of the price associated with the order.
+template<typename T>
+class alignas(cache_line_size) CompactOrder {
+public:
+    using PriceType = T;
+    using Clock = TscClock;
+    using TimePoint = Clock::time_point;
+
+    CompactOrder() = default;
+    /// @brief  Specific initialization
+    /// @throw std::length_error if id is longer than a ClOrdID
+    explicit CompactOrder(OrderSide side, OrderType type, OrderTimeInForce tif, T price,
+        std::size_t quantity, std::string_view id, TimePoint time = Clock::now()) :
+        hot_{price, {}, quantity, {}, {}, {}, side, type, tif},
+        cold_{time, {}, FixedId<order_id_width>(id), {}, {}} {}
+
+    void Price(T price) { hot_.price_ = price; }
+    void StopPrice(T price) { hot_.stop_price_ = price; }
+    void Quantity(size_t quantity) { hot_.quantity_ = quantity; }
+    void MaxShow(size_t max_show) { hot_.max_show_ = max_show; }
+    void MinQty(size_t min_qty) { hot_.min_qty_ = min_qty; }
+    void Time(TimePoint time) { cold_.time_ = time; }
+    void ExpireTime(TimePoint time) { cold_.expire_time_ = time; }
+    void Side(OrderSide side) { hot_.side_ = side; }
+    void Type(OrderType type) { hot_.type_ = type; }
+    void TIF(OrderTimeInForce tif) { hot_.tif_ = tif; }
+    void Key(std::uint64_t key) { hot_.key_ = key; }
+    /// @throw std::length_error if account is longer than a FIX Account
+    void Account(std::string_view account) { cold_.account_ = FixedId<account_width>(account); }
+    /// @throw std::length_error if session is longer than a SenderCompID
+    void Session(std::string_view session) { cold_.session_ = FixedId<session_width>(session); }
+
+    std::string_view Id() const { return cold_.id_.View(); }
+    auto Price() const { return hot_.price_; }
+    auto StopPrice() const { return hot_.stop_price_; }
+    auto Quantity() const { return hot_.quantity_; }
+    auto MaxShow() const { return hot_.max_show_; }
+    auto MinQty() const { return hot_.min_qty_; }
+    auto Time() const { return cold_.time_; }
+    auto ExpireTime() const { return cold_.expire_time_; }
+    auto Side() const { return hot_.side_; }
+    auto Type() const { return hot_.type_; }
+    auto TIF() const { return hot_.tif_; }
+    auto Key() const { return hot_.key_; }
+    std::string_view Account() const { return cold_.account_.View(); }
+    std::string_view Session() const { return cold_.session_.View(); }
+
+private:
+    /// @brief What matching, resting and triggering consult
+    struct Hot {
+        T price_{};
+        T stop_price_{};
+        std::size_t quantity_{};
+        std::size_t max_show_{};
+        std::size_t min_qty_{};
+        std::uint64_t key_{};
+        OrderSide side_{OrderSide::UNKNOWN};
+        OrderType type_{OrderType::UNKNOWN};
+        OrderTimeInForce tif_{OrderTimeInForce::UNKNOWN};
+    };
+    static_assert(sizeof(Hot) <= cache_line_size, "Matching fields must fit in a cache line");
+    /// @brief What only reporting, journalling and mass cancels consult
+    struct Cold {
+        TimePoint time_{};
+        TimePoint expire_time_{};
+        FixedId<order_id_width> id_{};
+        FixedId<account_width> account_{};
+        FixedId<session_width> session_{};
+    };
+    static_assert(sizeof(Cold) <= cache_line_size, "Identifying fields must fit in a cache line");
+
+    Hot hot_{};
+    alignas(cache_line_size) Cold cold_{};
+};
+static_assert(sizeof(CompactOrder<std::int64_t>) == 2 * cache_line_size, "Compact order must span two cache lines");
+}
@@ -0,0 +1,244 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <MatchingEngine.h>
+#include    <Journal.h>
+#include    <Ring.h>
+#include    <IdleStrategy.h>
+#include    <Affinity.h>
+
+#include    <atomic>
+#include    <chrono>
+#include    <cstddef>
+#include    <cstdint>
+#include    <exception>
+#include    <functional>
+#include    <memory>
+#include    <optional>
+#include    <stdexcept>
+#include    <string>
+#include    <thread>
+#include    <unordered_map>
+#include    <vector>
+
+namespace pentifica::trd::exch {
+/// @brief Run time settings of an @ref EngineRuntime
+struct RuntimeOptions {
+    /// @brief The number of worker threads
+    std::size_t workers_{1};
+    /// @brief The capacity of each worker's inbound queue
+    std::size_t queue_capacity_{65536};
+    /// @brief The maximum number of requests a worker handles per poll
+    std::size_t batch_size_{64};
+    /// @brief How often a worker expires the good till date orders of its books
+    std::chrono::milliseconds expiry_interval_{1};
+    /// @brief The cpu each worker is pinned to. Workers without an entry
+    ///        are not pinned.
+    std::vector<int> cpus_{};
+    /// @brief Where each worker journals the requests it applies, as
+    ///        <journal_>.<worker>; empty for no journals
+    std::string journal_{};
+    JournalOptions journal_options_{};
+};
+/// @brief  Owns one @ref MatchingEngine per symbol and spreads the symbols
+///         over worker threads. Each worker busy-polls its own single
+///         producer, single consumer inbound queue, so every book is only
+///         ever touched by one thread and keeps its deterministic order.
+///         Callbacks run on the worker thread owning the symbol; every
+///         book touched by a poll is flushed once at the end of the poll.
+///         Workers also expire the good till date orders of their books,
+///         at most once per expiry interval; a book that expired orders
+///         counts as touched. Given a journal, each worker journals every
+///         request before applying it, and every expiry that removed orders,
+///         and commits at the end of each poll; Recover rebuilds the books
+///         from the journals.
+/// @tparam OrderDef The order type
+/// @tparam Callback The engine callback type. See @ref MatchingEngine
+/// @tparam Config Compile time engine selections. See @ref EngineConfig
+/// @tparam Idle What a worker does when its queue is empty. See
+///         BusySpinIdle, YieldingIdle and BackoffIdle
+template<typename OrderDef, typename Callback, typename Config = EngineConfig,
+    typename Idle = BackoffIdle>
+class EngineRuntime {
+public:
+    using Engine = MatchingEngine<OrderDef, Callback, Config>;
+    using Request = Engine::Request;
+    using SymbolId = std::uint32_t;
+    using OnError = std::function<void(SymbolId, std::exception const&)>;
+    /// @brief Prepare a runtime. Workers are not started.
+    /// @param options Run time settings
+    /// @param on_error Invoked on the worker thread when a request throws
+    explicit EngineRuntime(RuntimeOptions options, OnError on_error = {}) :
+        options_{std::move(options)},
+        on_error_{std::move(on_error)}
+    {
+        if(options_.workers_ == 0) throw std::invalid_argument("workers == 0");
+        for(std::size_t index = 0; index < options_.workers_; ++index) {
+            workers_.push_back(std::make_unique<Worker>(options_.queue_capacity_));
+            if(options_.journal_.empty()) continue;
+            workers_.back()->journal_ = std::make_unique<Journal>(JournalPath(index), options_.journal_options_);
+        }
+    }
+    EngineRuntime(EngineRuntime const&) = delete;
+    EngineRuntime(EngineRuntime&&) = delete;
+    ~EngineRuntime() { Stop(); }
+    EngineRuntime& operator=(EngineRuntime const&) = delete;
+    EngineRuntime& operator=(EngineRuntime&&) = delete;
+    /// @brief Add a book for a symbol. Only allowed while stopped.
+    /// @param symbol The symbol's name
+    /// @param callback The callback of the symbol's engine
+    /// @return The identifier to submit requests for the symbol with
+    SymbolId AddSymbol(std::string const& symbol, Callback callback) {
+        if(Running()) throw std::logic_error("Symbols cannot be added while running");
+        auto const id{static_cast<SymbolId>(engines_.size())};
+        auto [_, added] = symbols_.try_emplace(symbol, id);
+        if(!added) throw std::invalid_argument("Duplicate symbol");
+        engines_.push_back(std::make_unique<Engine>(std::move(callback)));
+        return id;
+    }
+    /// @brief Look up a symbol's identifier
+    std::optional<SymbolId> Find(std::string const& symbol) const {
+        auto entry{symbols_.find(symbol)};
+        if(entry == symbols_.end()) return std::nullopt;
+        return entry->second;
+    }
+    /// @brief Returns the worker a symbol's book belongs to
+    std::size_t WorkerOf(SymbolId symbol) const { return symbol % workers_.size(); }
+    /// @brief Returns a symbol's book. Only to be inspected while stopped.
+    Engine const& Book(SymbolId symbol) const { return *engines_.at(symbol); }
+    /// @brief  Rebuild the books from the workers' journals. Only allowed
+    ///         while stopped, once the symbols have been added in the order,
+    ///         and with the number of workers, the journals were written with.
+    /// @return The number of requests replayed
+    std::size_t Recover() {
+        if(Running()) throw std::logic_error("Books cannot be recovered while running");
+        std::size_t count{};
+        for(std::size_t index = 0; index < workers_.size() && workers_[index]->journal_; ++index) {
+            JournalReader<OrderDef, typename Config::Keys> reader(JournalPath(index));
+            count += reader.ReplayBooks([this](std::uint64_t symbol) -> Engine* {
+                return symbol < engines_.size() ? engines_[symbol].get() : nullptr;
+            });
+        }
+        return count;
+    }
+    /// @brief Start the worker threads
+    void Start() {
+        if(running_.exchange(true)) return;
+        for(std::size_t index = 0; index < workers_.size(); ++index) {
+            auto const cpu{index < options_.cpus_.size() ? options_.cpus_[index] : -1};
+            workers_[index]->thread_ = std::thread([this, index, cpu]() { Run(index, cpu); });
+        }
+    }
+    /// @brief Stop the worker threads once they have drained their queues
+    void Stop() {
+        if(!running_.exchange(false)) return;
+        for(auto& worker : workers_) worker->thread_.join();
+    }
+    bool Running() const { return running_.load(std::memory_order_acquire); }
+    /// @brief  Queue a request for a symbol's book. Requests must be
+    ///         submitted from one thread at a time.
+    /// @param symbol The symbol the request applies to
+    /// @param request The request
+    /// @return false if the owning worker's queue is full
+    bool Submit(SymbolId symbol, Request request) {
+        if(symbol >= engines_.size()) throw std::out_of_range("Unknown symbol");
+        return workers_[WorkerOf(symbol)]->inbound_.TryPush(Routed{symbol, std::move(request)});
+    }
+
+private:
+    /// @brief A request along with the symbol it applies to
+    struct Routed {
+        SymbolId symbol_{};
+        Request request_{};
+    };
+    using Journal = exch::Journal<OrderDef, typename Config::Keys>;
+    struct Worker {
+        explicit Worker(std::size_t capacity) : inbound_{capacity} {}
+        SpscRing<Routed> inbound_;
+        std::unique_ptr<Journal> journal_{};
+        std::thread thread_{};
+    };
+    std::string JournalPath(std::size_t worker) const { return options_.journal_ + "." + std::to_string(worker); }
+    /// @brief A worker's poll loop
+    void Run(std::size_t index, int cpu) {
+        if(cpu >= 0) PinCurrentThread(cpu);
+
+        auto& inbound{workers_[index]->inbound_};
+        auto* journal{workers_[index]->journal_.get()};
+        std::vector<std::size_t> touched(engines_.size());
+        std::vector<SymbolId> flush;
+        flush.reserve(engines_.size());
+        std::vector<SymbolId> owned;
+        for(SymbolId symbol = 0; symbol < engines_.size(); ++symbol) {
+            if(WorkerOf(symbol) == index) owned.push_back(symbol);
+        }
+        auto dispatch = [&](Routed& routed) {
+            if(touched[routed.symbol_]++ == 0) flush.push_back(routed.symbol_);
+            Dispatch(routed, journal);
+        };
+        auto next_expiry{OrderDef::Clock::now()};
+        auto expire = [&]() {
+            auto const now{OrderDef::Clock::now()};
+            if(now < next_expiry) return;
+            next_expiry = now + options_.expiry_interval_;
+            for(auto symbol : owned) {
+                if(engines_[symbol]->Expire(now) == 0) continue;
+                //  Nothing reaches the book in between, so the record replays
+                //  the same removals
+                if(journal) journal->AppendExpire(now, symbol);
+                if(touched[symbol]++ == 0) flush.push_back(symbol);
+            }
+        };
+        auto poll = [&]() {
+            auto const count{inbound.Drain(dispatch, options_.batch_size_)};
+            expire();
+            for(auto symbol : flush) {
+                engines_[symbol]->Flush(touched[symbol]);
+                touched[symbol] = 0;
+            }
+            flush.clear();
+            if(journal) journal->Commit();
+            return count;
+        };
+
+        Idle idle{};
+        while(Running()) idle.Idle(poll());
+        while(poll() != 0) {}
+    }
+    /// @brief Journal a request, if journaling, then apply it to its symbol's book
+    void Dispatch(Routed& routed, Journal* journal) {
+        try {
+            if(journal) journal->Append(routed.request_, routed.symbol_);
+            engines_[routed.symbol_]->Apply(routed.request_);
+        }
+        catch(std::exception const& error) {
+            if(on_error_) on_error_(routed.symbol_, error);
+        }
+        routed.request_ = Request{};
+    }
+
+    RuntimeOptions const options_;
+    OnError const on_error_;
+    std::vector<std::unique_ptr<Worker>> workers_{};
+    std::vector<std::unique_ptr<Engine>> engines_{};
+    std::unordered_map<std::string, SymbolId> symbols_{};
+    std::atomic<bool> running_{false};
+};
+}
@@ -0,0 +1,255 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <algorithm>
+#include    <array>
+#include    <atomic>
+#include    <bit>
+#include    <chrono>
+#include    <cstddef>
+#include    <cstdint>
+#include    <type_traits>
+
+namespace pentifica::trd::exch {
+/// @brief The engine operations whose latency is recorded
+enum class EngineOperation:char {FILL = 'F', CANCEL = 'C', REVISE = 'R', UNKNOWN = 'U'};
+/// @brief  The counts of a @ref LatencyHistogram as copied at one moment
+/// @tparam Buckets The number of buckets
+template<std::size_t Buckets>
+struct HistogramSnapshot {
+    std::array<std::uint64_t, Buckets> counts_{};
+    std::uint64_t count_{};
+    std::uint64_t sum_{};
+    std::uint64_t max_{};
+};
+/// @brief  A fixed memory histogram of nanosecond latencies in HDR style:
+///         values below 2^(SubBucketBits+1) are counted exactly and each
+///         larger power of 2 is split into 2^SubBucketBits equal buckets, so
+///         every value is recorded within a relative error of
+///         2^-SubBucketBits. Values beyond 2^MaxBits - 1 are counted in the
+///         last bucket. A histogram is recorded to by one thread; any thread
+///         may take a snapshot of it at any time without locking.
+/// @tparam SubBucketBits   The log 2 of the number of buckets per power of 2
+/// @tparam MaxBits         The log 2 of the largest value resolved
+template<std::size_t SubBucketBits = 7, std::size_t MaxBits = 36>
+class LatencyHistogram {
+    static_assert(SubBucketBits > 0 && MaxBits > SubBucketBits + 1 && MaxBits < 64,
+        "Histogram must resolve more than its sub-buckets");
+public:
+    static constexpr std::size_t sub_buckets{std::size_t{1} << SubBucketBits};
+    static constexpr std::size_t buckets{(MaxBits - SubBucketBits + 1) * sub_buckets};
+    using Snapshot = HistogramSnapshot<buckets>;
+
+    LatencyHistogram() = default;
+    LatencyHistogram(LatencyHistogram const&) = delete;
+    LatencyHistogram& operator=(LatencyHistogram const&) = delete;
+    /// @brief Count a value
+    void Record(std::uint64_t value) {
+        Bump(counts_[Index(value)], 1);
+        Bump(count_, 1);
+        Bump(sum_, value);
+        if(value > max_.load(std::memory_order_relaxed)) max_.store(value, std::memory_order_relaxed);
+    }
+    /// @brief Copy the counts
+    Snapshot Take() const {
+        Snapshot snapshot;
+        for(std::size_t index = 0; index < buckets; ++index) {
+            snapshot.counts_[index] = counts_[index].load(std::memory_order_relaxed);
+        }
+        snapshot.count_ = count_.load(std::memory_order_relaxed);
+        snapshot.sum_ = sum_.load(std::memory_order_relaxed);
+        snapshot.max_ = max_.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+    /// @brief Returns the bucket a value is counted in
+    static std::size_t Index(std::uint64_t value) {
+        auto const width{static_cast<std::size_t>(std::bit_width(value))};
+        auto const shift{width > SubBucketBits + 1 ? width - SubBucketBits - 1 : 0};
+        return std::min(shift * sub_buckets + static_cast<std::size_t>(value >> shift), buckets - 1);
+    }
+    /// @brief Returns the largest value counted in a bucket
+    static std::uint64_t Highest(std::size_t index) {
+        if(index < 2 * sub_buckets) return index;
+        auto const shift{index / sub_buckets - 1};
+        return ((std::uint64_t{index - shift * sub_buckets} + 1) << shift) - 1;
+    }
+    /// @brief  Returns the value at or below which a fraction of the values
+    ///         in a snapshot lie, as the largest value of its bucket
+    /// @param snapshot The snapshot
+    /// @param percentile The fraction of values, 0 to 100
+    static std::uint64_t ValueAt(Snapshot const& snapshot, double percentile) {
+        std::uint64_t total{};
+        for(auto count : snapshot.counts_) total += count;
+        if(total == 0) return 0;
+
+        auto const wanted{std::max<std::uint64_t>(1,
+            static_cast<std::uint64_t>(static_cast<double>(total) * std::clamp(percentile, 0.0, 100.0) / 100.0 + 0.5))};
+        std::uint64_t seen{};
+        for(std::size_t index = 0; index < buckets; ++index) {
+            seen += snapshot.counts_[index];
+            if(seen >= wanted) return std::min(Highest(index), snapshot.max_);
+        }
+        return snapshot.max_;
+    }
+
+private:
+    /// @brief Add to a counter only this thread writes
+    static void Bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<std::uint64_t>, buckets> counts_{};
+    std::atomic<std::uint64_t> count_{};
+    std::atomic<std::uint64_t> sum_{};
+    std::atomic<std::uint64_t> max_{};
+};
+/// @brief  What an engine's statistics held at one moment. Each figure is
+///         read atomically, the set as a whole is not: figures may be a few
+///         operations apart.
+/// @tparam Histogram The latency histogram type
+template<typename Histogram>
+struct EngineStatsSnapshot {
+    using Latency = Histogram::Snapshot;
+
+    /// @brief Returns the latencies of an operation
+    Latency const& Of(EngineOperation operation) const { return latency_[Slot(operation)]; }
+    /// @brief Returns the latency of an operation at a percentile, in nanoseconds
+    std::uint64_t Percentile(EngineOperation operation, double percentile) const {
+        return Histogram::ValueAt(Of(operation), percentile);
+    }
+
+    static std::size_t Slot(EngineOperation operation) {
+        switch(operation) {
+            case EngineOperation::FILL:     return 0;
+            case EngineOperation::CANCEL:   return 1;
+            case EngineOperation::REVISE:   return 2;
+            default:                        return 3;
+        }
+    }
+
+    std::array<Latency, 4> latency_{};
+    /// @brief Executions against resting orders
+    std::uint64_t fills_{};
+    /// @brief Incoming orders that reached at least one price level
+    std::uint64_t sweeps_{};
+    /// @brief Price levels reached, over all sweeps
+    std::uint64_t levels_swept_{};
+    /// @brief The most price levels one sweep reached
+    std::uint64_t max_levels_swept_{};
+    /// @brief Resting orders, stops included, after the last operation
+    std::uint64_t resting_{};
+    /// @brief Live price levels on both sides after the last operation
+    std::uint64_t levels_{};
+};
+/// @brief  Instrumentation compiled out: every hook is empty, so an engine
+///         configured with it carries no cost
+struct NoEngineStats {
+    static constexpr bool enabled{false};
+    /// @brief Stands in for a timer
+    struct Timer {};
+
+    template<typename Probe>
+    Timer Start(EngineOperation, Probe&&) { return {}; }
+    void Filled() {}
+    void Swept(std::size_t) {}
+};
+/// @brief  Records the latency of each engine operation, measured with the
+///         steady clock, in a @ref LatencyHistogram together with counters
+///         of executions, levels swept and the size of the book. The engine
+///         thread records; a monitoring thread reads through Snapshot.
+/// @tparam Histogram The latency histogram type
+template<typename Histogram = LatencyHistogram<>>
+class EngineStats {
+public:
+    static constexpr bool enabled{true};
+    using Snapshot = EngineStatsSnapshot<Histogram>;
+    /// @brief  Times an operation from its construction to its destruction,
+    ///         then publishes the size of the book as reported by a probe
+    /// @tparam Probe Returns the resting orders and live levels as a pair
+    template<typename Probe>
+    class Timer {
+    public:
+        Timer(EngineStats& stats, EngineOperation operation, Probe probe) :
+            stats_{stats}, operation_{operation}, probe_{probe}, start_{std::chrono::steady_clock::now()} {}
+        Timer(Timer const&) = delete;
+        Timer& operator=(Timer const&) = delete;
+        ~Timer() {
+            //  an interval, so from a clock that never steps backwards
+            auto const elapsed{std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_)};
+            stats_.latency_[Snapshot::Slot(operation_)].Record(static_cast<std::uint64_t>(elapsed.count()));
+            auto const [resting, levels] = probe_();
+            stats_.resting_.store(resting, std::memory_order_relaxed);
+            stats_.levels_.store(levels, std::memory_order_relaxed);
+        }
+
+    private:
+        EngineStats& stats_;
+        EngineOperation const operation_;
+        Probe probe_;
+        std::chrono::steady_clock::time_point const start_;
+    };
+
+    EngineStats() = default;
+    EngineStats(EngineStats const&) = delete;
+    EngineStats& operator=(EngineStats const&) = delete;
+    /// @brief Start timing an operation
+    template<typename Probe>
+    Timer<std::decay_t<Probe>> Start(EngineOperation operation, Probe&& probe) {
+        return {*this, operation, std::forward<Probe>(probe)};
+    }
+    /// @brief Count an execution against a resting order
+    void Filled() { Bump(fills_, 1); }
+    /// @brief Count the price levels an incoming order reached
+    void Swept(std::size_t levels) {
+        if(levels == 0) return;
+        Bump(sweeps_, 1);
+        Bump(levels_swept_, levels);
+        if(levels > max_levels_swept_.load(std::memory_order_relaxed)) {
+            max_levels_swept_.store(levels, std::memory_order_relaxed);
+        }
+    }
+    /// @brief Copy the statistics. Safe from any thread.
+    Snapshot Take() const {
+        Snapshot snapshot;
+        for(std::size_t slot = 0; slot < latency_.size(); ++slot) snapshot.latency_[slot] = latency_[slot].Take();
+        snapshot.fills_ = fills_.load(std::memory_order_relaxed);
+        snapshot.sweeps_ = sweeps_.load(std::memory_order_relaxed);
+        snapshot.levels_swept_ = levels_swept_.load(std::memory_order_relaxed);
+        snapshot.max_levels_swept_ = max_levels_swept_.load(std::memory_order_relaxed);
+        snapshot.resting_ = resting_.load(std::memory_order_relaxed);
+        snapshot.levels_ = levels_.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+private:
+    static void Bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    std::array<Histogram, 4> latency_{};
+    std::atomic<std::uint64_t> fills_{};
+    std::atomic<std::uint64_t> sweeps_{};
+    std::atomic<std::uint64_t> levels_swept_{};
+    std::atomic<std::uint64_t> max_levels_swept_{};
+    std::atomic<std::uint64_t> resting_{};
+    std::atomic<std::uint64_t> levels_{};
+};
+}
@@ -0,0 +1,136 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <Order.h>
+#include    <OrderKeys.h>
+#include    <FixedId.h>
+
+#include    <concepts>
+#include    <cstddef>
+#include    <cstdint>
+#include    <span>
+#include    <string_view>
+#include    <type_traits>
+#include    <vector>
+
+namespace pentifica::trd::exch {
+/// @brief Identifies the kind of an @ref ExecutionEvent
+enum class ExecutionType:char {TRADE = 'T', CANCEL = 'C', REVISE = 'R', REST = 'A', UNKNOWN = 'U'};
+/// @brief  A fixed size record of something the engine did to an order
+/// @tparam PriceType The price type
+/// @tparam IdType How orders are identified
+template<typename PriceType, typename IdType>
+struct ExecutionEvent {
+    /// @brief Position of the event in the stream, starting at 1
+    std::uint64_t sequence_;
+    /// @brief The aggressor of a trade, otherwise the order concerned
+    IdType id_;
+    /// @brief The resting order of a trade
+    IdType resting_id_;
+    /// @brief The trade price, otherwise the order's price
+    PriceType price_;
+    /// @brief The quantity traded, otherwise the order's remaining quantity
+    std::size_t quantity_;
+    ExecutionType type_;
+    /// @brief The side of the aggressor of a trade, otherwise of the order
+    OrderSide side_;
+};
+/// @brief  A callback that takes what the engine does to orders as direct
+///         calls rather than as signals carrying order references. The engine
+///         rejects orders the recorder cannot tell apart, for which Fits is
+///         false.
+template<typename Sink, typename OrderDef>
+concept ExecutionRecorder = requires(Sink& sink, OrderDef const& order,
+    typename OrderDef::PriceType price, std::size_t quantity) {
+    { sink.Fits(order) } -> std::convertible_to<bool>;
+    sink.RecordTrade(order, order, price, quantity);
+    sink.RecordCancel(order);
+    sink.RecordRevise(order);
+    sink.RecordRest(order);
+};
+/// @brief  An engine callback that writes what the engine does as flat
+///         @ref ExecutionEvent records into a preallocated buffer for
+///         consumers to drain in bulk. The engine recognizes it and records
+///         trades, cancels, revisions and resting orders without building
+///         the reference carrying signals. Other signals are ignored. Pass it
+///         to the engine by reference: MatchingEngine<Order, Stream&>.
+/// @tparam OrderDef The order type
+/// @tparam Keys How orders are identified. Keys with trivially copyable
+///         key types are recorded as is, others as a @ref FixedId, so orders
+///         whose key is longer than a ClOrdID do not fit.
+template<typename OrderDef, typename Keys = IdKeys>
+class ExecutionStream {
+public:
+    using PriceType = OrderDef::PriceType;
+    using KeyType = Keys::KeyType;
+    using IdType = std::conditional_t<std::is_trivially_copyable_v<KeyType>, KeyType, FixedId<>>;
+    using Event = ExecutionEvent<PriceType, IdType>;
+    static_assert(std::is_trivially_copyable_v<Event>);
+    /// @brief Prepare a stream
+    /// @param capacity The number of events to preallocate. The buffer only
+    ///        grows if more are recorded between drains.
+    explicit ExecutionStream(std::size_t capacity) { events_.reserve(capacity); }
+
+    void RecordTrade(OrderDef const& aggressor, OrderDef const& resting,
+        PriceType price, std::size_t quantity) {
+        events_.push_back(Event{++sequence_, Id(aggressor), Id(resting), price, quantity,
+            ExecutionType::TRADE, aggressor.Side()});
+    }
+    /// @brief Indicates if an order's key can be recorded in full
+    static bool Fits(OrderDef const& order) {
+        if constexpr(std::is_same_v<IdType, KeyType>) return true;
+        else return std::string_view(Keys::Key(order)).size() <= order_id_width;
+    }
+    void RecordCancel(OrderDef const& order) { Record(ExecutionType::CANCEL, order); }
+    void RecordRevise(OrderDef const& order) { Record(ExecutionType::REVISE, order); }
+    void RecordRest(OrderDef const& order) { Record(ExecutionType::REST, order); }
+    /// @brief Signals without a record are ignored
+    template<typename Signal>
+    void operator()(Signal const&) {}
+    /// @brief Returns the events recorded since the last drain
+    std::span<Event const> Events() const { return events_; }
+    /// @brief Hand the events recorded since the last drain to a consumer
+    ///        and discard them
+    /// @param consume Invoked once with a std::span of the events
+    /// @return The number of events drained
+    template<typename Consume>
+    std::size_t Drain(Consume&& consume) {
+        auto const count{events_.size()};
+        if(count) consume(Events());
+        events_.clear();
+        return count;
+    }
+    /// @brief Returns the sequence number of the last event recorded
+    std::uint64_t Sequence() const { return sequence_; }
+
+private:
+    static IdType Id(OrderDef const& order) {
+        if constexpr(std::is_same_v<IdType, KeyType>) return Keys::Key(order);
+        else return IdType(Keys::Key(order));
+    }
+    void Record(ExecutionType type, OrderDef const& order) {
+        events_.push_back(Event{++sequence_, Id(order), IdType{}, order.Price(), order.Quantity(),
+            type, order.Side()});
+    }
+
+    std::vector<Event> events_{};
+    std::uint64_t sequence_{};
+};
+}
@@ -0,0 +1,85 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <parser/fix/Tags.h>
+
+#include    <algorithm>
+#include    <compare>
+#include    <cstddef>
+#include    <cstdint>
+#include    <functional>
+#include    <stdexcept>
+#include    <string_view>
+
+namespace pentifica::trd::exch {
+/// @brief The width of a FIX ClOrdID, the natural bound on order identifiers
+inline constexpr std::size_t order_id_width{static_cast<std::size_t>(fix::TagWidth::ClOrdID)};
+/// @brief The width of a FIX Account
+inline constexpr std::size_t account_width{static_cast<std::size_t>(fix::TagWidth::Account)};
+/// @brief The width of a FIX SenderCompID, which identifies a session
+inline constexpr std::size_t session_width{static_cast<std::size_t>(fix::TagWidth::SenderCompID)};
+/// @brief  An identifier stored inline in a fixed number of characters.
+///         Trivially copyable, so it can be held in flat records.
+/// @tparam N The maximum number of characters
+template<std::size_t N = order_id_width>
+class FixedId {
+    static_assert(N <= UINT8_MAX, "FixedId is limited to 255 characters");
+public:
+    FixedId() = default;
+    /// @brief Initialize from a string
+    /// @throw std::length_error if the string is longer than N
+    explicit FixedId(std::string_view id) {
+        if(id.size() > N) throw std::length_error("Identifier too long");
+        Assign(id);
+    }
+    /// @brief Initialize from the first N characters of a string
+    static FixedId Truncated(std::string_view id) {
+        FixedId result;
+        result.Assign(id.substr(0, std::min(id.size(), N)));
+        return result;
+    }
+
+    std::string_view View() const { return {data_, size_}; }
+    std::size_t Size() const { return size_; }
+    bool Empty() const { return size_ == 0; }
+
+    friend bool operator==(FixedId const& lhs, FixedId const& rhs) { return lhs.View() == rhs.View(); }
+    friend auto operator<=>(FixedId const& lhs, FixedId const& rhs) { return lhs.View() <=> rhs.View(); }
+
+private:
+    void Assign(std::string_view id) {
+        std::copy(id.begin(), id.end(), data_);
+        size_ = static_cast<std::uint8_t>(id.size());
+    }
+
+    char data_[N]{};
+    std::uint8_t size_{};
+};
+/// @brief  Hashes identifiers held as a FixedId or as any string type alike,
+///         so a container keyed by std::string may be searched with a
+///         std::string_view without building a key
+struct IdHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view id) const { return std::hash<std::string_view>{}(id); }
+    template<std::size_t N>
+    std::size_t operator()(FixedId<N> const& id) const { return (*this)(id.View()); }
+};
+}
@@ -0,0 +1,196 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <algorithm>
+#include    <bit>
+#include    <cstddef>
+#include    <cstdint>
+#include    <utility>
+#include    <vector>
+
+namespace pentifica::trd::exch {
+/// @brief Scrambles integer keys so that sequential keys spread over a table
+struct FlatHash {
+    std::size_t operator()(std::uint64_t key) const {
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+        return static_cast<std::size_t>(key);
+    }
+};
+/// @brief  An open addressing (linear probing) hash map for small trivially
+///         copyable keys and values. When the table outgrows its load limit
+///         a table of twice the size is started and entries migrate to it a
+///         few slots per operation, so no single operation pays for a full
+///         rehash. Lookups consult both tables while a migration is under way.
+/// @tparam Key     The key type
+/// @tparam Value   The value type
+/// @tparam Hash    Hashes a key
+template<typename Key, typename Value, typename Hash = FlatHash>
+class FlatHashMap {
+public:
+    /// @brief Prepare a map able to hold reserve entries without growing
+    /// @param reserve The number of entries to provision for
+    explicit FlatHashMap(std::size_t reserve = 0) :
+        active_{std::bit_ceil(std::max(min_capacity, reserve * 2))} {}
+    /// @brief Locate the value associated with a key
+    /// @return The value or nullptr if the key is not present
+    Value* Find(Key const& key) {
+        Migrate();
+        if(auto* slot{active_.Find(key)}) return &slot->value_;
+        if(auto* slot{old_.Find(key)}) return &slot->value_;
+        return nullptr;
+    }
+    /// @brief Locate the value associated with a key, inserting a default
+    ///        value if the key is not present
+    /// @return The value and true if it was inserted
+    std::pair<Value*, bool> TryEmplace(Key const& key) {
+        Migrate();
+        if(auto* slot{old_.Find(key)}) return {&slot->value_, false};
+
+        auto [slot, added] = active_.Insert(key);
+        if(added && active_.size_ * 2 > active_.Capacity()) Grow();
+        return {&slot->value_, added};
+    }
+    /// @brief Remove a key
+    void Erase(Key const& key) {
+        Migrate();
+        if(!active_.Erase(key)) old_.Bury(key);
+    }
+    /// @brief Returns the number of entries
+    std::size_t Size() const { return active_.size_ + old_.size_; }
+    /// @brief Indicates if entries are migrating to a larger table
+    bool Migrating() const { return !old_.slots_.empty(); }
+    /// @brief Visit every entry
+    /// @param visit Invoked with the key and value of each entry
+    template<typename Visit>
+    void ForEach(Visit&& visit) {
+        old_.ForEach(visit);
+        active_.ForEach(visit);
+    }
+
+private:
+    static constexpr std::size_t min_capacity{16};
+    static constexpr std::size_t migrate_per_operation{16};
+
+    enum class State:std::uint8_t {EMPTY, FULL, ERASED};
+
+    struct Slot {
+        Key key_{};
+        Value value_{};
+        State state_{State::EMPTY};
+    };
+
+    struct Table {
+        Table() = default;
+        explicit Table(std::size_t capacity) : slots_(capacity), mask_{capacity - 1} {}
+
+        std::size_t Capacity() const { return slots_.size(); }
+        std::size_t Home(Key const& key) const { return Hash{}(key) & mask_; }
+
+        Slot* Find(Key const& key) {
+            if(size_ == 0) return nullptr;
+            for(auto index{Home(key)};; index = (index + 1) & mask_) {
+                auto& slot{slots_[index]};
+                if(slot.state_ == State::EMPTY) return nullptr;
+                if(slot.state_ == State::FULL && slot.key_ == key) return &slot;
+            }
+        }
+        std::pair<Slot*, bool> Insert(Key const& key) {
+            for(auto index{Home(key)};; index = (index + 1) & mask_) {
+                auto& slot{slots_[index]};
+                if(slot.state_ == State::EMPTY) {
+                    slot.key_ = key;
+                    slot.value_ = Value{};
+                    slot.state_ = State::FULL;
+                    ++size_;
+                    return {&slot, true};
+                }
+                if(slot.state_ == State::FULL && slot.key_ == key) return {&slot, false};
+            }
+        }
+        /// @brief Remove a key, shifting later members of its cluster back
+        ///        so that no tombstone is left behind
+        bool Erase(Key const& key) {
+            auto* slot{Find(key)};
+            if(!slot) return false;
+
+            auto hole{static_cast<std::size_t>(slot - slots_.data())};
+            for(auto index{(hole + 1) & mask_};
+                slots_[index].state_ == State::FULL;
+                index = (index + 1) & mask_) {
+                auto const home{Home(slots_[index].key_)};
+                if(((index - home) & mask_) >= ((index - hole) & mask_)) {
+                    slots_[hole] = slots_[index];
+                    hole = index;
+                }
+            }
+            slots_[hole].state_ = State::EMPTY;
+            --size_;
+            return true;
+        }
+        /// @brief Remove a key leaving a tombstone so that a migration scan
+        ///        never sees entries move behind it
+        void Bury(Key const& key) {
+            if(auto* slot{Find(key)}) {
+                slot->state_ = State::ERASED;
+                --size_;
+            }
+        }
+        template<typename Visit>
+        void ForEach(Visit& visit) {
+            for(auto& slot : slots_) {
+                if(slot.state_ == State::FULL) visit(slot.key_, slot.value_);
+            }
+        }
+
+        std::vector<Slot> slots_{};
+        std::size_t mask_{};
+        std::size_t size_{};
+    };
+    /// @brief Start migrating to a table of twice the capacity
+    void Grow() {
+        while(Migrating()) Migrate();
+        old_ = std::move(active_);
+        active_ = Table{old_.Capacity() * 2};
+        cursor_ = 0;
+    }
+    /// @brief Move a bounded number of slots from the old table
+    void Migrate() {
+        if(!Migrating()) return;
+
+        auto const end{std::min(cursor_ + migrate_per_operation, old_.Capacity())};
+        for(; cursor_ < end; ++cursor_) {
+            auto& slot{old_.slots_[cursor_]};
+            if(slot.state_ != State::FULL) continue;
+            active_.Insert(slot.key_).first->value_ = slot.value_;
+            slot.state_ = State::ERASED;
+            --old_.size_;
+        }
+        if(cursor_ == old_.Capacity()) old_ = Table{};
+    }
+
+    Table active_;
+    Table old_{};
+    std::size_t cursor_{};
+};
+}
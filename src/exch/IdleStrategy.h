@@ -0,0 +1,78 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <algorithm>
+#include    <chrono>
+#include    <cstddef>
+#include    <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include    <immintrin.h>
+#endif
+
+namespace pentifica::trd::exch {
+/// @brief Hint to the processor that the caller is spinning
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+/// @brief Never gives up the core. Lowest latency, burns a core when idle.
+struct BusySpinIdle {
+    void Idle(std::size_t work_count) { if(work_count == 0) CpuRelax(); }
+};
+/// @brief Yields the core to other threads whenever there was nothing to do
+struct YieldingIdle {
+    void Idle(std::size_t work_count) { if(work_count == 0) std::this_thread::yield(); }
+};
+/// @brief  Spins, then yields, then sleeps with exponentially increasing
+///         periods while there is no work. Any work resets the progression.
+struct BackoffIdle {
+    std::size_t max_spins_{100};
+    std::size_t max_yields_{10};
+    std::chrono::nanoseconds min_sleep_{std::chrono::microseconds(1)};
+    std::chrono::nanoseconds max_sleep_{std::chrono::milliseconds(1)};
+
+    void Idle(std::size_t work_count) {
+        if(work_count != 0) {
+            spins_ = yields_ = 0;
+            sleep_ = min_sleep_;
+            return;
+        }
+        if(spins_ < max_spins_) {
+            ++spins_;
+            CpuRelax();
+        }
+        else if(yields_ < max_yields_) {
+            ++yields_;
+            std::this_thread::yield();
+        }
+        else {
+            std::this_thread::sleep_for(sleep_);
+            sleep_ = std::min(sleep_ * 2, max_sleep_);
+        }
+    }
+
+private:
+    std::size_t spins_{};
+    std::size_t yields_{};
+    std::chrono::nanoseconds sleep_{min_sleep_};
+};
+}
@@ -0,0 +1,126 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <cstddef>
+#include    <iterator>
+
+namespace pentifica::trd::exch {
+/// @brief  Links embedded in an element of an @ref IntrusiveList. An element
+///         may belong to several lists at once by deriving from one link per
+///         list, each distinguished by its tag.
+/// @tparam T   The element type
+/// @tparam Tag Distinguishes the list the links belong to
+template<typename T, typename Tag = void>
+struct IntrusiveLink {
+    T* prev_{};
+    T* next_{};
+};
+/// @brief  A doubly linked FIFO whose links live in the elements. Elements
+///         are neither allocated nor owned by the list so that insertion and
+///         removal of any element is O(1).
+/// @tparam T   The element type, derived from IntrusiveLink<T, Tag>
+/// @tparam Tag Selects which of the element's links the list uses
+template<typename T, typename Tag = void>
+class IntrusiveList {
+public:
+    using Link = IntrusiveLink<T, Tag>;
+    /// @brief Forward iteration over the elements of the list
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        Iterator() = default;
+        explicit Iterator(T* item) : item_{item} {}
+
+        T& operator*() const { return *item_; }
+        T* operator->() const { return item_; }
+        Iterator& operator++() { item_ = Links(*item_).next_; return *this; }
+        Iterator operator++(int) { auto save{*this}; ++*this; return save; }
+        bool operator==(Iterator const&) const = default;
+
+    private:
+        T* item_{};
+    };
+
+    IntrusiveList() = default;
+    IntrusiveList(IntrusiveList const&) = delete;
+    IntrusiveList(IntrusiveList&& other) noexcept :
+        head_{other.head_},
+        tail_{other.tail_},
+        size_{other.size_} { other.Reset(); }
+    ~IntrusiveList() = default;
+    IntrusiveList& operator=(IntrusiveList const&) = delete;
+    IntrusiveList& operator=(IntrusiveList&& other) noexcept {
+        head_ = other.head_;
+        tail_ = other.tail_;
+        size_ = other.size_;
+        other.Reset();
+        return *this;
+    }
+
+    bool Empty() const { return head_ == nullptr; }
+    std::size_t Size() const { return size_; }
+    T& Front() const { return *head_; }
+    T& Back() const { return *tail_; }
+
+    Iterator begin() const { return Iterator{head_}; }
+    Iterator end() const { return Iterator{}; }
+    /// @brief Append an element to the end of the list
+    /// @param item The element to append. It must not be in the list.
+    void PushBack(T& item) {
+        auto& links{Links(item)};
+        links.prev_ = tail_;
+        links.next_ = nullptr;
+        if(tail_)   Links(*tail_).next_ = &item;
+        else        head_ = &item;
+        tail_ = &item;
+        ++size_;
+    }
+    /// @brief Remove the element at the front of the list
+    void PopFront() { Erase(*head_); }
+    /// @brief Remove an element from the list
+    /// @param item The element to remove. It must be in the list.
+    void Erase(T& item) {
+        auto& links{Links(item)};
+        if(links.prev_) Links(*links.prev_).next_ = links.next_;
+        else            head_ = links.next_;
+        if(links.next_) Links(*links.next_).prev_ = links.prev_;
+        else            tail_ = links.prev_;
+        links.prev_ = links.next_ = nullptr;
+        --size_;
+    }
+    /// @brief Forget all elements without touching them
+    void Reset() {
+        head_ = tail_ = nullptr;
+        size_ = 0;
+    }
+
+private:
+    static Link& Links(T& item) { return static_cast<Link&>(item); }
+
+    T* head_{};
+    T* tail_{};
+    std::size_t size_{};
+};
+}
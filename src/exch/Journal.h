@@ -0,0 +1,424 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <MatchingEngine.h>
+#include    <MappedFile.h>
+#include    <FixedId.h>
+
+#include    <algorithm>
+#include    <atomic>
+#include    <chrono>
+#include    <cstddef>
+#include    <cstdint>
+#include    <cstring>
+#include    <memory>
+#include    <mutex>
+#include    <stdexcept>
+#include    <string>
+#include    <thread>
+#include    <type_traits>
+#include    <utility>
+#include    <vector>
+
+namespace pentifica::trd::exch {
+/// @brief Identifies how far a journal commit pushes records towards the disk
+///         - NONE: left to the kernel. Survives a process crash.
+///         - ASYNC: written back is scheduled without waiting.
+///         - SYNC: waits until written back. Survives a system crash.
+enum class JournalSync:char {NONE = 'N', ASYNC = 'A', SYNC = 'S'};
+/// @brief Tuning of a @ref Journal
+struct JournalOptions {
+    /// @brief Records appended before a commit happens without being asked for
+    std::size_t group_size_{256};
+    /// @brief Records the file is preallocated for, and extended by should
+    ///        they run out
+    std::size_t capacity_records_{1 << 20};
+    JournalSync sync_{JournalSync::ASYNC};
+    /// @brief How often the writer thread looks for committed records
+    std::chrono::microseconds writer_interval_{500};
+};
+/// @brief  A journaled engine input
+/// @tparam PriceType The price type
+template<typename PriceType>
+struct JournalRecord {
+    /// @brief Position in the journal, starting at 1
+    std::uint64_t sequence_;
+    /// @brief Order time, the time a cancel was journaled or the time orders
+    ///        expired by, in nanoseconds since the clock's epoch
+    std::int64_t timestamp_;
+    /// @brief A good till date order's expiry time, in nanoseconds since the
+    ///        clock's epoch
+    std::int64_t expire_time_;
+    std::uint64_t key_;
+    std::uint64_t quantity_;
+    std::uint64_t max_show_;
+    std::uint64_t min_qty_;
+    /// @brief The book the record applies to, for journals shared by books
+    std::uint64_t symbol_;
+    PriceType price_;
+    PriceType stop_price_;
+    /// @brief The order id, or the key of a cancel when keys are not integral
+    FixedId<> id_;
+    FixedId<account_width> account_;
+    FixedId<session_width> session_;
+    EngineAction action_;
+    OrderSide side_;
+    OrderType type_;
+    OrderTimeInForce tif_;
+};
+/// @brief Describe an order as a journal record
+/// @throw std::length_error if the order's id, account or session is too
+///        long to record
+template<typename OrderDef>
+JournalRecord<typename OrderDef::PriceType> RecordOf(std::uint64_t sequence, EngineAction action,
+    OrderDef const& order) {
+    using std::chrono::duration_cast;
+    using std::chrono::nanoseconds;
+    return {sequence,
+        duration_cast<nanoseconds>(order.Time().time_since_epoch()).count(),
+        duration_cast<nanoseconds>(order.ExpireTime().time_since_epoch()).count(),
+        order.Key(), order.Quantity(), order.MaxShow(), order.MinQty(), 0,
+        order.Price(), order.StopPrice(), FixedId<>(order.Id()),
+        FixedId<account_width>(order.Account()), FixedId<session_width>(order.Session()),
+        action, order.Side(), order.Type(), order.TIF()};
+}
+/// @brief Rebuild the order a journal record describes
+template<typename OrderDef>
+OrderDef OrderOf(JournalRecord<typename OrderDef::PriceType> const& record) {
+    auto time = [](std::int64_t nanoseconds) {
+        return typename OrderDef::TimePoint(std::chrono::duration_cast<typename OrderDef::Clock::duration>(
+            std::chrono::nanoseconds(nanoseconds)));
+    };
+    OrderDef order(record.side_, record.type_, record.tif_, record.price_, record.quantity_,
+        std::string(record.id_.View()), time(record.timestamp_));
+    order.ExpireTime(time(record.expire_time_));
+    order.StopPrice(record.stop_price_);
+    order.MaxShow(record.max_show_);
+    order.MinQty(record.min_qty_);
+    order.Key(record.key_);
+    order.Account(std::string(record.account_.View()));
+    order.Session(std::string(record.session_.View()));
+    return order;
+}
+/// @brief Layout shared by journal writers and readers
+struct JournalFormat {
+    static constexpr std::uint64_t magic{0x4c4e524a44525450};   //  "PTRDJRNL"
+    static constexpr std::uint32_t version{3};
+    static constexpr std::size_t header_size{64};
+
+    struct Header {
+        std::uint64_t magic_;
+        std::uint32_t version_;
+        std::uint32_t record_size_;
+        /// @brief The number of records a reader may rely on
+        std::uint64_t committed_;
+    };
+    static_assert(sizeof(Header) <= header_size);
+
+    static Header& HeaderOf(std::byte* data) { return *reinterpret_cast<Header*>(data); }
+    /// @brief Check that a mapped journal holds records of the expected size
+    /// @throw std::runtime_error if it does not
+    static void Check(Header const& header, std::size_t record_size, std::size_t file_size) {
+        if(header.magic_ != magic || header.version_ != version || header.record_size_ != record_size) {
+            throw std::runtime_error("Journal format mismatch");
+        }
+        if(header_size + header.committed_ * record_size > file_size) {
+            throw std::runtime_error("Journal truncated");
+        }
+    }
+};
+/// @brief  Appends engine inputs to a memory mapped, append-only file
+///         preallocated for capacity_records_ records. An append copies a
+///         fixed size record into the mapping, with no system call; records
+///         are committed in groups, either every group_size_ appends or when
+///         Commit is called, typically at the end of a batch. A commit only
+///         publishes how far the journal has been written: a writer thread
+///         pushes committed records towards the disk, as the sync option
+///         directs, and then makes them visible to readers. The file is
+///         extended on the appending thread only once the preallocated records
+///         run out. Reopening a journal continues after its last committed
+///         record.
+/// @tparam OrderDef The order type
+/// @tparam Keys How orders are identified. See @ref EngineConfig
+template<typename OrderDef, typename Keys = IdKeys>
+class Journal {
+public:
+    using PriceType = OrderDef::PriceType;
+    using KeyType = Keys::KeyType;
+    using Record = JournalRecord<PriceType>;
+    static_assert(std::is_trivially_copyable_v<Record>);
+    /// @brief Open or create a journal and start its writer thread
+    /// @throw std::system_error if the file cannot be mapped
+    /// @throw std::runtime_error if the file is not a compatible journal
+    explicit Journal(std::string const& path, JournalOptions options = {}) :
+        options_{options},
+        file_{path, MapMode::WRITE, JournalFormat::header_size + options.capacity_records_ * sizeof(Record)}
+    {
+        auto& header{Header()};
+        if(header.magic_ == 0) {
+            header = JournalFormat::Header{JournalFormat::magic, JournalFormat::version, sizeof(Record), 0};
+        }
+        JournalFormat::Check(header, sizeof(Record), file_.Size());
+        written_ = header.committed_;
+        published_.store(written_, std::memory_order_relaxed);
+        committed_.store(written_, std::memory_order_relaxed);
+        writer_ = std::thread([this]() { Write(); });
+    }
+    Journal(Journal const&) = delete;
+    Journal(Journal&&) = delete;
+    ~Journal() {
+        stopping_.store(true, std::memory_order_release);
+        writer_.join();
+        try { Sync(); }
+        catch(...) {}
+    }
+    Journal& operator=(Journal const&) = delete;
+    Journal& operator=(Journal&&) = delete;
+    /// @brief Journal a buy, sell or revise
+    /// @return The record's sequence number
+    /// @throw std::length_error if the order's id is too long to journal
+    std::uint64_t Append(EngineAction action, OrderDef const& order) {
+        return Append(RecordOf(written_ + 1, action, order));
+    }
+    /// @brief Journal a cancel
+    /// @return The record's sequence number
+    std::uint64_t Append(KeyType const& key) { return Append(Cancel(key)); }
+    /// @brief Journal the end of the trading day
+    /// @return The record's sequence number
+    std::uint64_t AppendEndOfDay() { return Append(Marker(EngineAction::END_OF_DAY)); }
+    /// @brief Journal the removal of the good till date orders expired by a time
+    /// @param now The time passed to the engine's Expire
+    /// @param symbol The book expired, for journals shared by books
+    /// @return The record's sequence number
+    std::uint64_t AppendExpire(typename OrderDef::TimePoint now, std::uint64_t symbol = 0) {
+        auto record{Expire(now)};
+        record.symbol_ = symbol;
+        return Append(record);
+    }
+    /// @brief Journal a queued engine request
+    /// @param request The request
+    /// @param symbol The book the request is for, for journals shared by books
+    /// @return The record's sequence number
+    template<typename Payload>
+    std::uint64_t Append(EngineRequest<Payload, KeyType> const& request, std::uint64_t symbol = 0) {
+        auto record{RecordFor(request)};
+        record.symbol_ = symbol;
+        return Append(record);
+    }
+    /// @brief Hand the records appended so far to the writer thread. Makes
+    ///        no system call.
+    void Commit() { published_.store(written_, std::memory_order_release); }
+    /// @brief Commit, then push the records committed towards the disk and
+    ///        make them visible to readers on the calling thread, as at
+    ///        shutdown. Not meant for the appending thread while it matches.
+    void Sync() {
+        Commit();
+        Flush();
+    }
+    /// @brief Returns the number of records appended
+    std::uint64_t Written() const { return written_; }
+    /// @brief Returns the number of records visible to readers
+    std::uint64_t Committed() const { return committed_.load(std::memory_order_acquire); }
+
+private:
+    JournalFormat::Header& Header() { return JournalFormat::HeaderOf(file_.Data()); }
+    static std::size_t Offset(std::uint64_t index) { return JournalFormat::header_size + index * sizeof(Record); }
+    /// @brief Returns the record of an action that carries no order, stamped now
+    Record Marker(EngineAction action) const {
+        return {written_ + 1,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                OrderDef::Clock::now().time_since_epoch()).count(),
+            0, 0, 0, 0, 0, 0, PriceType{}, PriceType{}, FixedId<>{}, {}, {},
+            action, OrderSide::UNKNOWN, OrderType::UNKNOWN, OrderTimeInForce::UNKNOWN};
+    }
+    Record Cancel(KeyType const& key) const {
+        auto record{Marker(EngineAction::CANCEL)};
+        if constexpr(std::is_integral_v<KeyType>)   record.key_ = key;
+        else                                        record.id_ = FixedId<>(key);
+        return record;
+    }
+    Record Expire(typename OrderDef::TimePoint now) const {
+        auto record{Marker(EngineAction::EXPIRE)};
+        record.timestamp_ = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+        return record;
+    }
+    /// @throw std::logic_error if the request's action is invalid, as the
+    ///        engine would
+    template<typename Payload>
+    Record RecordFor(EngineRequest<Payload, KeyType> const& request) const {
+        switch(request.action_) {
+            case EngineAction::CANCEL:      return Cancel(request.key_);
+            case EngineAction::END_OF_DAY:  return Marker(EngineAction::END_OF_DAY);
+            case EngineAction::BUY: case EngineAction::SELL: case EngineAction::REVISE:
+            case EngineAction::CANCEL_ACCOUNT: case EngineAction::CANCEL_SESSION:
+            case EngineAction::EXPIRE:      break;
+            default: throw std::logic_error("Request action invalid");
+        }
+        if constexpr(std::is_same_v<Payload, OrderDef>) {
+            if(request.action_ == EngineAction::EXPIRE) return Expire(request.order_.Time());
+            return RecordOf(written_ + 1, request.action_, request.order_);
+        }
+        else {
+            if(request.action_ == EngineAction::EXPIRE) return Expire(request.order_->Time());
+            return RecordOf(written_ + 1, request.action_, *request.order_);
+        }
+    }
+
+    std::uint64_t Append(Record const& record) {
+        auto const offset{Offset(written_)};
+        if(offset + sizeof(Record) > file_.Size()) {
+            std::lock_guard lock{mapping_};
+            file_.Resize(file_.Size() + options_.capacity_records_ * sizeof(Record));
+        }
+        std::memcpy(file_.Data() + offset, &record, sizeof(Record));
+        ++written_;
+        if(written_ - published_.load(std::memory_order_relaxed) >= options_.group_size_) Commit();
+        return record.sequence_;
+    }
+    /// @brief The writer thread: flush what has been committed until stopped
+    void Write() {
+        while(!stopping_.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(options_.writer_interval_);
+            try { Flush(); }
+            catch(...) {}
+        }
+    }
+    /// @brief  Push the committed records not yet flushed towards the disk,
+    ///         then make them visible to readers. The mapping is held while
+    ///         flushing so the appending thread cannot move it.
+    void Flush() {
+        std::lock_guard lock{mapping_};
+        auto const committed{committed_.load(std::memory_order_relaxed)};
+        auto const published{published_.load(std::memory_order_acquire)};
+        if(published == committed) return;
+        auto const wait{options_.sync_ == JournalSync::SYNC};
+        if(options_.sync_ != JournalSync::NONE) {
+            file_.Sync(Offset(committed), (published - committed) * sizeof(Record), wait);
+        }
+        Header().committed_ = published;
+        if(options_.sync_ != JournalSync::NONE) file_.Sync(0, JournalFormat::header_size, wait);
+        committed_.store(published, std::memory_order_release);
+    }
+
+    JournalOptions const options_;
+    MappedFile file_;
+    /// @brief Records appended; only touched by the appending thread
+    std::uint64_t written_{};
+    /// @brief Records handed to the writer thread
+    std::atomic<std::uint64_t> published_{};
+    /// @brief Records visible to readers
+    std::atomic<std::uint64_t> committed_{};
+    std::atomic<bool> stopping_{};
+    /// @brief Held while the mapping is flushed or moved
+    std::mutex mapping_{};
+    std::thread writer_{};
+};
+/// @brief  Reads the committed records of a journal written by @ref Journal
+///         and replays them into an engine to rebuild its book
+/// @tparam OrderDef The order type
+/// @tparam Keys How orders are identified. See @ref EngineConfig
+template<typename OrderDef, typename Keys = IdKeys>
+class JournalReader {
+public:
+    using PriceType = OrderDef::PriceType;
+    using KeyType = Keys::KeyType;
+    using Record = JournalRecord<PriceType>;
+    /// @throw std::system_error if the file cannot be mapped
+    /// @throw std::runtime_error if the file is not a compatible journal
+    explicit JournalReader(std::string const& path) : file_{path, MapMode::READ} {
+        if(file_.Size() < JournalFormat::header_size) throw std::runtime_error("Journal truncated");
+        auto const& header{*reinterpret_cast<JournalFormat::Header const*>(file_.Data())};
+        JournalFormat::Check(header, sizeof(Record), file_.Size());
+        size_ = header.committed_;
+        file_.Sequential();
+    }
+    /// @brief Returns the number of committed records
+    std::size_t Size() const { return size_; }
+    /// @brief Returns a record, copied out of the mapping
+    /// @param index The record's index, its sequence number less 1
+    Record operator[](std::size_t index) const {
+        Record record;
+        std::memcpy(&record, file_.Data() + JournalFormat::header_size + index * sizeof(Record), sizeof(Record));
+        return record;
+    }
+    /// @brief Rebuild the order a record describes
+    static OrderDef ToOrder(Record const& record) { return OrderOf<OrderDef>(record); }
+    /// @brief Apply the committed records to an engine, then flush it once
+    /// @param engine The engine to rebuild
+    /// @param after Skip records with a sequence number at or below this
+    /// @return The number of records applied
+    template<typename Engine>
+    std::size_t Replay(Engine& engine, std::uint64_t after = 0) {
+        std::size_t count{};
+        for(auto index{after}; index < size_; ++index, ++count) {
+            auto request{RequestOf<Engine>((*this)[index])};
+            engine.Apply(request);
+        }
+        engine.Flush(count);
+        return count;
+    }
+    /// @brief  Apply the committed records of a journal shared by several
+    ///         books, each to the engine of its symbol, then flush each
+    ///         engine given records once
+    /// @param engine_of Returns a pointer to the engine of a symbol; null to
+    ///        skip the symbol's records
+    /// @param after Skip records with a sequence number at or below this
+    /// @return The number of records applied
+    template<typename EngineOf>
+    std::size_t ReplayBooks(EngineOf&& engine_of, std::uint64_t after = 0) {
+        using Engine = std::remove_pointer_t<std::invoke_result_t<EngineOf&, std::uint64_t>>;
+        std::vector<std::pair<Engine*, std::size_t>> touched;
+        std::size_t count{};
+        for(auto index{after}; index < size_; ++index) {
+            auto const record{(*this)[index]};
+            auto* engine{engine_of(record.symbol_)};
+            if(!engine) continue;
+            auto request{RequestOf<Engine>(record)};
+            engine->Apply(request);
+            auto book{std::find_if(touched.begin(), touched.end(),
+                [engine](auto const& entry) { return entry.first == engine; })};
+            if(book == touched.end()) touched.emplace_back(engine, 1);
+            else                      ++book->second;
+            ++count;
+        }
+        for(auto [engine, requests] : touched) engine->Flush(requests);
+        return count;
+    }
+
+private:
+    /// @brief Rebuild the request a record describes
+    template<typename Engine>
+    static typename Engine::Request RequestOf(Record const& record) {
+        typename Engine::Request request{record.action_};
+        if(record.action_ == EngineAction::CANCEL) {
+            if constexpr(std::is_integral_v<KeyType>)   request.key_ = record.key_;
+            else                                        request.key_ = KeyType(record.id_.View());
+        }
+        else if(record.action_ != EngineAction::END_OF_DAY) {
+            if constexpr(Engine::shared_orders) request.order_ = std::make_shared<OrderDef>(ToOrder(record));
+            else request.order_ = ToOrder(record);
+        }
+        return request;
+    }
+
+    MappedFile file_;
+    std::size_t size_{};
+};
+}
@@ -0,0 +1,230 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <MatchingEngine.h>
+#include    <Ring.h>
+
+#include    <atomic>
+#include    <cstddef>
+#include    <cstdint>
+#include    <limits>
+#include    <map>
+#include    <memory>
+#include    <utility>
+#include    <vector>
+
+namespace pentifica::trd::exch {
+/// @brief  Identifies what an @ref L2Update does to a consumer's book.
+///         SNAPSHOT clears the consumer's book; the complete book follows
+///         as NEW updates in the same batch.
+enum class L2Action:char {NEW = 'N', CHANGE = 'C', DELETE = 'D', SNAPSHOT = 'S', UNKNOWN = 'U'};
+/// @brief  A change to one price level of a depth of book feed
+/// @tparam PriceType The price type
+template<typename PriceType>
+struct L2Update {
+    /// @brief The engine batch the update belongs to, starting at 1
+    std::uint64_t sequence_;
+    PriceType price_;
+    std::size_t quantity_;
+    std::size_t orders_;
+    L2Action action_;
+    OrderSide side_;
+};
+/// @brief  Consumer end of an @ref L2Publisher feed. Each subscription is
+///         drained by a single consumer thread.
+/// @tparam PriceType The price type
+template<typename PriceType>
+class L2Subscription {
+public:
+    using Update = L2Update<PriceType>;
+
+    explicit L2Subscription(std::size_t capacity) : ring_{capacity} {}
+    /// @brief Consumer: remove up to limit updates, oldest first
+    /// @param visit Invoked with each update removed
+    /// @param limit The maximum number of updates to remove
+    /// @return The number of updates removed
+    template<typename Visit>
+    std::size_t Drain(Visit&& visit, std::size_t limit) {
+        return ring_.Drain(std::forward<Visit>(visit), limit);
+    }
+    /// @brief Returns the number of times the consumer fell behind and was
+    ///        sent a snapshot in place of the updates it missed
+    std::size_t Conflations() const { return conflations_.load(std::memory_order_relaxed); }
+
+private:
+    template<typename> friend class L2Publisher;
+
+    std::size_t Room() const { return ring_.Capacity() - ring_.Size(); }
+
+    SpscRing<Update> ring_;
+    std::atomic<std::size_t> conflations_{};
+    bool stale_{};
+};
+/// @brief  Turns the level signals of a @ref MatchingEngine into a depth of
+///         book feed. On the engine thread, a level signal only copies the
+///         level into a preallocated ring, and a flush marks the end of the
+///         batch there; nothing is allocated or looked up. The publisher
+///         thread polls the ring, keeps the image of the book, coalesces the
+///         changes to a level within a batch and publishes them as single
+///         updates once the batch's end is reached. The publisher never
+///         waits on a consumer: one without room for a whole batch skips it
+///         and, once it has room, is sent a snapshot of the book in place of
+///         everything it missed. Forward EngineOnLevel and EngineOnFlush
+///         signals to it from the engine's callback.
+/// @tparam PriceType The price type
+template<typename PriceType>
+class L2Publisher {
+public:
+    using Update = L2Update<PriceType>;
+    using Subscription = L2Subscription<PriceType>;
+    /// @param capacity The number of level changes the engine may get ahead
+    ///        of the publisher thread by. The engine waits for room only if
+    ///        the publisher falls further behind.
+    explicit L2Publisher(std::size_t capacity = 65536) : deltas_{capacity} {}
+    /// @brief Add a consumer. Only from the publisher thread, between polls.
+    /// @param capacity The number of updates the consumer may fall behind by
+    ///        before it is conflated. Should exceed the number of levels in
+    ///        the book for snapshots to fit.
+    /// @return The consumer's end of the feed
+    Subscription& Subscribe(std::size_t capacity) {
+        auto& subscription{*subscriptions_.emplace_back(std::make_unique<Subscription>(capacity))};
+        subscription.stale_ = !bids_.empty() || !asks_.empty();
+        return subscription;
+    }
+
+    void operator()(EngineOnLevel<PriceType> const& signal) { Push(Delta{signal.level_, signal.side_}); }
+    void operator()(EngineOnFlush const&) { Push(Delta{}); }
+    /// @brief  Publisher thread: apply the level changes the engine made,
+    ///         publishing each batch whose end has been reached
+    /// @param limit The maximum number of changes to take
+    /// @return The number of changes and batch ends taken
+    std::size_t Poll(std::size_t limit = std::numeric_limits<std::size_t>::max()) {
+        return deltas_.Drain([this](Delta const& delta) {
+            if(delta.side_ == OrderSide::UNKNOWN)   Publish();
+            else                                    Apply(delta);
+        }, limit);
+    }
+    /// @brief Returns the number of times the engine waited for the
+    ///        publisher thread to make room
+    std::size_t Stalls() const { return stalls_.load(std::memory_order_relaxed); }
+    /// @brief Returns the sequence number of the last batch published
+    std::uint64_t Sequence() const { return sequence_; }
+
+private:
+    /// @brief A level as the engine reported it; the end of a batch when
+    ///        its side is unknown
+    struct Delta {
+        BookLevel<PriceType> level_{};
+        OrderSide side_{OrderSide::UNKNOWN};
+    };
+    struct ImageLevel {
+        BookLevel<PriceType> published_{};
+        BookLevel<PriceType> current_{};
+        bool dirty_{};
+    };
+    /// @brief The published book of one side, in ascending price order
+    using Image = std::map<PriceType, ImageLevel>;
+    /// @brief A level changed in the current batch
+    struct Dirty {
+        OrderSide side_;
+        Image::iterator index_;
+    };
+
+    /// @brief Engine thread: queue a change for the publisher thread
+    void Push(Delta const& delta) {
+        if(deltas_.TryPush(delta)) return;
+        stalls_.fetch_add(1, std::memory_order_relaxed);
+        while(!deltas_.TryPush(delta)) {}
+    }
+    void Apply(Delta const& delta) {
+        auto index{Side(delta.side_).try_emplace(delta.level_.price_).first};
+        auto& level{index->second};
+        if(!level.dirty_) {
+            level.dirty_ = true;
+            dirty_.push_back({delta.side_, index});
+        }
+        level.current_ = delta.level_;
+    }
+    /// @brief Publish the changes made in the batch just ended
+    void Publish() {
+        if(dirty_.empty() && !Stale()) return;
+        ++sequence_;
+
+        updates_.clear();
+        for(auto [side, index] : dirty_) {
+            auto& level{index->second};
+            auto const& before{level.published_};
+            auto const& after{level.current_};
+            level.dirty_ = false;
+            if(before.orders_ == 0 && after.orders_ != 0)   Add(L2Action::NEW, side, after);
+            else if(before.orders_ != 0 && after.orders_ == 0) Add(L2Action::DELETE, side, before);
+            else if(after.orders_ != 0 && (before.quantity_ != after.quantity_
+                || before.orders_ != after.orders_))        Add(L2Action::CHANGE, side, after);
+            level.published_ = after;
+            if(after.orders_ == 0) Side(side).erase(index);
+        }
+        dirty_.clear();
+
+        for(auto& subscription : subscriptions_) {
+            if(!subscription->stale_ && !updates_.empty()) {
+                if(subscription->Room() >= updates_.size()) {
+                    for(auto const& update : updates_) subscription->ring_.TryPush(update);
+                    continue;
+                }
+                subscription->stale_ = true;
+                subscription->conflations_.fetch_add(1, std::memory_order_relaxed);
+            }
+            if(subscription->stale_) SendSnapshot(*subscription);
+        }
+    }
+    void Add(L2Action action, OrderSide side, BookLevel<PriceType> const& level) {
+        updates_.push_back(Update{sequence_, level.price_, level.quantity_, level.orders_, action, side});
+    }
+    Image& Side(OrderSide side) { return side == OrderSide::BUY ? bids_ : asks_; }
+    bool Stale() const {
+        for(auto const& subscription : subscriptions_) if(subscription->stale_) return true;
+        return false;
+    }
+    /// @brief Send the complete book to a consumer that has room for it
+    void SendSnapshot(Subscription& subscription) {
+        if(subscription.Room() < bids_.size() + asks_.size() + 1) return;
+        subscription.ring_.TryPush(Update{sequence_, PriceType{}, 0, 0, L2Action::SNAPSHOT, OrderSide::UNKNOWN});
+        auto send = [this, &subscription](OrderSide side, auto begin, auto end) {
+            for(; begin != end; ++begin) {
+                auto const& level{begin->second.published_};
+                subscription.ring_.TryPush(Update{sequence_, level.price_, level.quantity_,
+                    level.orders_, L2Action::NEW, side});
+            }
+        };
+        send(OrderSide::BUY, bids_.rbegin(), bids_.rend());
+        send(OrderSide::SELL, asks_.begin(), asks_.end());
+        subscription.stale_ = false;
+    }
+
+    SpscRing<Delta> deltas_;
+    std::atomic<std::size_t> stalls_{};
+    Image bids_{};
+    Image asks_{};
+    std::vector<Dirty> dirty_{};
+    std::vector<Update> updates_{};
+    std::vector<std::unique_ptr<Subscription>> subscriptions_{};
+    std::uint64_t sequence_{};
+};
+}
@@ -0,0 +1,112 @@
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    [[noreturn]] void Fail(char const* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+}
+
+namespace pentifica::trd::exch {
+//  ---------------------------------------------------------------------------
+//
+MappedFile::MappedFile(std::string const& path, MapMode mode, std::size_t size) :
+    mode_{mode}
+{
+    fd_ = (mode_ == MapMode::WRITE) ? ::open(path.c_str(), O_RDWR | O_CREAT, 0644)
+                                    : ::open(path.c_str(), O_RDONLY);
+    if(fd_ < 0) Fail("open");
+
+    struct stat status{};
+    if(::fstat(fd_, &status) != 0) {
+        ::close(fd_);
+        Fail("fstat");
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+
+    try {
+        if(mode_ == MapMode::WRITE && size > size_) Resize(size);
+        else Map();
+    }
+    catch(...) {
+        ::close(fd_);
+        throw;
+    }
+}
+//  ---------------------------------------------------------------------------
+//
+MappedFile::~MappedFile() {
+    Unmap();
+    ::close(fd_);
+}
+//  ---------------------------------------------------------------------------
+//
+void
+MappedFile::Resize(std::size_t size) {
+    Unmap();
+    if(::ftruncate(fd_, static_cast<off_t>(size)) != 0) Fail("ftruncate");
+    size_ = size;
+    Map();
+}
+//  ---------------------------------------------------------------------------
+//
+void
+MappedFile::Sync(std::size_t offset, std::size_t length, bool wait) {
+    if(!data_ || length == 0) return;
+    //  msync requires a page aligned start
+    auto const page{static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))};
+    auto const start{offset - offset % page};
+    if(::msync(data_ + start, length + (offset - start), wait ? MS_SYNC : MS_ASYNC) != 0) {
+        Fail("msync");
+    }
+}
+//  ---------------------------------------------------------------------------
+//
+void
+MappedFile::Sequential() {
+    if(data_) ::madvise(data_, size_, MADV_SEQUENTIAL);
+}
+//  ---------------------------------------------------------------------------
+//
+void
+MappedFile::Map() {
+    if(size_ == 0) return;
+    auto const protection{(mode_ == MapMode::WRITE) ? PROT_READ | PROT_WRITE : PROT_READ};
+    auto* data{::mmap(nullptr, size_, protection, MAP_SHARED, fd_, 0)};
+    if(data == MAP_FAILED) Fail("mmap");
+    data_ = static_cast<std::byte*>(data);
+}
+//  ---------------------------------------------------------------------------
+//
+void
+MappedFile::Unmap() {
+    if(data_) ::munmap(data_, size_);
+    data_ = nullptr;
+}
+}
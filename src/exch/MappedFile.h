@@ -0,0 +1,69 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <cstddef>
+#include    <string>
+
+namespace pentifica::trd::exch {
+/// @brief Identifies how a @ref MappedFile is opened
+enum class MapMode:char {READ = 'R', WRITE = 'W'};
+/// @brief  A file mapped into memory in its entirety. Writes through the
+///         mapping reach the page cache without a system call; Sync pushes
+///         them on to the file.
+class MappedFile {
+public:
+    /// @brief Map a file
+    /// @param path The file. In WRITE mode it is created if missing.
+    /// @param mode Whether the mapping may be written
+    /// @param size In WRITE mode, the file is extended to at least this size
+    /// @throw std::system_error if the file cannot be opened or mapped
+    MappedFile(std::string const& path, MapMode mode, std::size_t size = 0);
+    MappedFile(MappedFile const&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    ~MappedFile();
+    MappedFile& operator=(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    std::byte* Data() { return data_; }
+    std::byte const* Data() const { return data_; }
+    std::size_t Size() const { return size_; }
+    /// @brief Change the size of a writable file, remapping it. Pointers
+    ///        into the previous mapping are invalidated.
+    /// @throw std::system_error on failure
+    void Resize(std::size_t size);
+    /// @brief Write a range of the mapping back to the file
+    /// @param offset The start of the range
+    /// @param length The length of the range
+    /// @param wait Wait for the write to complete rather than schedule it
+    /// @throw std::system_error on failure
+    void Sync(std::size_t offset, std::size_t length, bool wait);
+    /// @brief Hint that the mapping will be read sequentially
+    void Sequential();
+
+private:
+    void Map();
+    void Unmap();
+
+    int fd_{-1};
+    MapMode mode_;
+    std::byte* data_{};
+    std::size_t size_{};
+};
+}
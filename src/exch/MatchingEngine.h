@@ -19,42 +19,150 @@
 /// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 /// SOFTWARE.
 #include    <Order.h>
+#include    <IntrusiveList.h>
+#include    <PriceLadder.h>
+#include    <ObjectPool.h>
+#include    <OrderStore.h>
+#include    <OrderKeys.h>
+#include    <ExecutionStream.h>
+#include    <TimingWheel.h>
+#include    <MatchingPolicy.h>
+#include    <EngineStats.h>
+#include    <FixedId.h>
+#include    <Ring.h>
+#include    <common/TscClock.h>
 
-#include    <list>
-#include    <map>
 #include    <unordered_map>
 #include    <memory>
+#include    <string>
+#include    <string_view>
+#include    <utility>
 #include    <exception>
+#include    <stdexcept>
 #include    <algorithm>
+#include    <chrono>
+#include    <cstddef>
+#include    <cstdint>
 #include    <functional>
+#include    <optional>
+#include    <span>
+#include    <type_traits>
+#include    <vector>
 
-#include    <iostream>
 namespace pentifica::trd::exch {
 
 /// @brief  Encapsulate information related to a trade signal
 /// @tparam OrderDef Order definition
-template<typename OrderDef>
+/// @tparam OrderRef How the engine refers to orders
+template<typename OrderDef, typename OrderRef = std::shared_ptr<OrderDef>>
 struct EngineOnTrade {
-    using OrderRef = std::shared_ptr<OrderDef>;
     OrderRef new_order_;
     OrderRef existing_order_;
     std::size_t quantity_;
 };
 /// @brief Encapsulate information related to a cancel signal
 /// @tparam OrderDef Order definition
-template<typename OrderDef>
+/// @tparam OrderRef How the engine refers to orders
+template<typename OrderDef, typename OrderRef = std::shared_ptr<OrderDef>>
 struct EngineOnCancel {
-    using OrderRef = std::shared_ptr<OrderDef>;
     OrderRef order_;
 };
 /// @brief Encapsualte information relted to a revise signal
 /// @tparam OrderDef Order definition
-template<typename OrderDef>
+/// @tparam OrderRef How the engine refers to orders
+template<typename OrderDef, typename OrderRef = std::shared_ptr<OrderDef>>
 struct EngineOnRevise {
-    using OrderRef = std::shared_ptr<OrderDef>;
     OrderRef order_;
 };
-/// @brief A simple matching engine that matches orders by price then time.
+/// @brief Signals a stop order was triggered and released to the book
+/// @tparam OrderDef Order definition
+/// @tparam OrderRef How the engine refers to orders
+template<typename OrderDef, typename OrderRef = std::shared_ptr<OrderDef>>
+struct EngineOnTrigger {
+    OrderRef order_;
+};
+/// @brief Identifies why the engine refused an order
+enum class RejectReason:char {POOL_EXHAUSTED = 'P', INSUFFICIENT_LIQUIDITY = 'L', INVALID_ID = 'I',
+    PRICE_OUT_OF_RANGE = 'R', AUCTION = 'A', DUPLICATE_ID = 'D', UNKNOWN = 'U'};
+/// @brief Encapsulate information related to a reject signal
+/// @tparam OrderDef Order definition
+template<typename OrderDef>
+struct EngineOnReject {
+    OrderDef const& order_;
+    RejectReason reason_;
+};
+/// @brief Signals the end of a batch of requests. Consumers may defer work
+///        triggered by the batch's other signals until it arrives.
+struct EngineOnFlush {
+    std::size_t requests_;
+};
+/// @brief  The aggregate of the orders resting at a price
+/// @tparam PriceType The price type
+template<typename PriceType>
+struct BookLevel {
+    PriceType price_;
+    std::size_t quantity_;
+    std::size_t orders_;
+
+    bool operator==(BookLevel const&) const = default;
+};
+/// @brief  Signals the aggregate of a price level changed. A level with no
+///         orders has been removed. Emitted once per level touched by a fill,
+///         not once per order filled.
+/// @tparam PriceType The price type
+template<typename PriceType>
+struct EngineOnLevel {
+    OrderSide side_;
+    BookLevel<PriceType> level_;
+};
+/// @brief  The outcome of an auction uncross
+/// @tparam PriceType The price type
+template<typename PriceType>
+struct AuctionResult {
+    /// @brief The equilibrium price every fill happened at
+    PriceType price_{};
+    /// @brief The quantity executed; 0 if the book did not cross
+    std::size_t quantity_{};
+};
+/// @brief Identifies what an @ref EngineRequest asks of the engine
+///         CANCEL_ACCOUNT and CANCEL_SESSION cancel every order of the account
+///         or session of the order they carry. EXPIRE removes the good till
+///         date orders expired by the time of the order it carries.
+enum class EngineAction:char {BUY = 'B', SELL = 'S', CANCEL = 'C', REVISE = 'R', END_OF_DAY = 'E',
+    CANCEL_ACCOUNT = 'A', CANCEL_SESSION = 'X', EXPIRE = 'T', UNKNOWN = 'U'};
+/// @brief  A request to the engine that can be queued and applied later
+/// @tparam Payload The order carried by buy, sell and revise requests
+/// @tparam KeyType Identifies the order a cancel request applies to
+template<typename Payload, typename KeyType>
+struct EngineRequest {
+    EngineAction action_{EngineAction::UNKNOWN};
+    Payload order_{};
+    KeyType key_{};
+};
+/// @brief Compile time configuration of a @ref MatchingEngine. Override
+///        selections by deriving from this and redefining them.
+struct EngineConfig {
+    /// @brief The price ladder implementation: MapLadders or TickLadders<Depth>
+    using Ladders = MapLadders;
+    /// @brief Where orders are kept: SharedOrders or PooledOrders<Capacity, Policy>
+    using Orders = SharedOrders;
+    /// @brief How orders are identified: IdKeys, FixedIdKeys<Reserve> or
+    ///        IntegerKeys<Reserve>
+    using Keys = IdKeys;
+    /// @brief The resolution good till date orders expire at
+    using ExpiryTick = std::chrono::milliseconds;
+    /// @brief How a price level's orders share a fill: FifoMatching,
+    ///        ProRataMatching, TopOrderMatching<Base> or LmmMatching<Percent, Base>
+    using Matching = FifoMatching;
+    /// @brief Operation latencies and book counters: NoEngineStats, which
+    ///        compiles them out, or EngineStats<Histogram>
+    using Stats = NoEngineStats;
+    /// @brief The number of book entries allocated at a time. The entry pool
+    ///        grows a slab at a time once the entries in hand are in use.
+    static constexpr std::size_t entry_slab_size{64};
+};
+/// @brief A simple matching engine that matches orders by price, then within a
+///        price as its matching policy directs, by default by time.
 /// @tparam OrderDef The order type
 /// @tparam Callback Provides handling for callback notification. Callbacks are
 ///                  based on operator() overloading with a single discriminator
@@ -62,18 +170,91 @@ struct EngineOnRevise {
 ///                     - EngineOnTrade
 ///                     - EngineOnCancel
 ///                     - EngineOnRevise
-template<typename OrderDef, typename Callback>
+///                     - EngineOnReject
+///                     - EngineOnTrigger
+///                     - EngineOnLevel
+///                     - EngineOnFlush
+///                  A callback satisfying @ref ExecutionRecorder, such as
+///                  @ref ExecutionStream, is instead told of trades, cancels,
+///                  revisions and resting orders through its Record methods.
+/// @tparam Config Compile time selections. See @ref EngineConfig
+template<typename OrderDef, typename Callback, typename Config = EngineConfig>
 class MatchingEngine {
 public:
-    using OrderRef = std::shared_ptr<OrderDef>;
+    using OrderStore = Config::Orders::template Store<OrderDef>;
+    using OrderRef = OrderStore::OrderRef;
     using PriceType = OrderDef::PriceType;
-    using PriceRung = std::list<OrderRef>;
-    using BuyLadder = std::map<PriceType, PriceRung, std::greater<PriceType>>;
-    using SellLadder = std::map<PriceType, PriceRung>;
-    using OrderBook = std::unordered_map<std::string, OrderRef>;
-    using OnTrade = EngineOnTrade<OrderDef>;
-    using OnCancel = EngineOnCancel<OrderDef>;
-    using OnRevise = EngineOnRevise<OrderDef>;
+    using TimePoint = OrderDef::TimePoint;
+    struct BookEntry;
+    /// @brief Distinguishes the links of an entry in its account's orders
+    struct AccountTag {};
+    /// @brief Distinguishes the links of an entry in its session's orders
+    struct SessionTag {};
+    /// @brief The resting orders of each account
+    using Accounts = std::unordered_map<std::string, IntrusiveList<BookEntry, AccountTag>, IdHash,
+        std::equal_to<>>;
+    /// @brief The resting orders of each session
+    using Sessions = std::unordered_map<std::string, IntrusiveList<BookEntry, SessionTag>, IdHash,
+        std::equal_to<>>;
+    /// @brief The orders resting at a price, in time priority, along with
+    ///        their aggregate displayed quantity
+    struct PriceRung {
+        PriceType price_{};
+        std::size_t quantity_{};
+        IntrusiveList<BookEntry> orders_{};
+        /// @brief The order that set the level as a new best price, while it
+        ///        keeps its place at the front
+        BookEntry* top_{};
+    };
+    /// @brief Indicates orders are laid out by cache line, as CompactOrder
+    ///        is, in which case so are book entries
+    static constexpr bool line_aligned{alignof(OrderDef) >= cache_line_size};
+    /// @brief A resting order along with its place in its price rung, in
+    ///        its account's and session's orders and, for a good till date
+    ///        order, in the expiry wheel. With line aligned orders an entry
+    ///        spans two cache lines: the expiry and owner links fill the
+    ///        first, the rung links and everything after them the second, so
+    ///        matching against a resting order touches two lines: the second
+    ///        of its entry and the first of its order. Otherwise entries are
+    ///        packed at their natural alignment.
+    struct alignas(line_aligned ? cache_line_size : alignof(OrderRef)) BookEntry : WheelLink<BookEntry>,
+        IntrusiveLink<BookEntry, AccountTag>, IntrusiveLink<BookEntry, SessionTag>,
+        IntrusiveLink<BookEntry> {
+        OrderRef order_{};
+        PriceRung* rung_{};
+        /// @brief The quantity the order displays in its rung
+        std::size_t quantity_{};
+        Accounts::value_type* account_{};
+        Sessions::value_type* session_{};
+    };
+    static_assert(!line_aligned || sizeof(BookEntry) == 2 * cache_line_size,
+        "Book entry must span two cache lines");
+    static_assert(!line_aligned || sizeof(WheelLink<BookEntry>) + sizeof(IntrusiveLink<BookEntry, AccountTag>)
+        + sizeof(IntrusiveLink<BookEntry, SessionTag>) == cache_line_size,
+        "Expiry and owner links must fill the first cache line of a book entry");
+    using Level = BookLevel<PriceType>;
+    using Ladders = Config::Ladders;
+    using BuyLadder = Ladders::template Ladder<PriceType, PriceRung, std::greater<PriceType>>;
+    using SellLadder = Ladders::template Ladder<PriceType, PriceRung, std::less<PriceType>>;
+    using Keys = Config::Keys;
+    using KeyType = Keys::KeyType;
+    using ExpiryTick = Config::ExpiryTick;
+    using Matching = Config::Matching;
+    using Stats = Config::Stats;
+    /// @brief Pending buy stops, lowest stop price first
+    using BuyStops = MapLadder<PriceType, PriceRung, std::less<PriceType>>;
+    /// @brief Pending sell stops, highest stop price first
+    using SellStops = MapLadder<PriceType, PriceRung, std::greater<PriceType>>;
+    using OrderBook = Keys::template Book<BookEntry*>;
+    using OnTrade = EngineOnTrade<OrderDef, OrderRef>;
+    using OnCancel = EngineOnCancel<OrderDef, OrderRef>;
+    using OnRevise = EngineOnRevise<OrderDef, OrderRef>;
+    using OnReject = EngineOnReject<OrderDef>;
+    using OnLevel = EngineOnLevel<PriceType>;
+    using OnTrigger = EngineOnTrigger<OrderDef, OrderRef>;
+    /// @brief Indicates orders are shared with the caller
+    static constexpr bool shared_orders{std::is_same_v<OrderRef, std::shared_ptr<OrderDef>>};
+    using Request = EngineRequest<std::conditional_t<shared_orders, OrderRef, OrderDef>, KeyType>;
 
     explicit MatchingEngine(Callback callback) : callback_(callback) {}
     MatchingEngine(MatchingEngine const&) = delete;
@@ -82,60 +263,828 @@ public:
     MatchingEngine& operator=(MatchingEngine const&) = delete;
     MatchingEngine& operator=(MatchingEngine&&) = delete;
 
-    void Buy(OrderRef& order) { Fill(order, sell_ladder_, buy_ladder_); }
-    void Sell(OrderRef& order) { Fill(order, buy_ladder_, sell_ladder_); }
+    void Buy(OrderRef& order) requires shared_orders {
+        [[maybe_unused]] auto const timer{Measure(EngineOperation::FILL)};
+        if(!Priced(*order) || !Identifiable(*order) || !Auctionable(*order)) return;
+        Fill(order, sell_ladder_, buy_ladder_, true);
+        ReleaseStops();
+    }
+    void Sell(OrderRef& order) requires shared_orders {
+        [[maybe_unused]] auto const timer{Measure(EngineOperation::FILL)};
+        if(!Priced(*order) || !Identifiable(*order) || !Auctionable(*order)) return;
+        Fill(order, buy_ladder_, sell_ladder_, true);
+        ReleaseStops();
+    }
+    /// @brief Submit a copy of a buy order to the engine
+    /// @param order The order to buy
+    /// @return false if the order was rejected
+    bool Buy(OrderDef const& order) {
+        [[maybe_unused]] auto const timer{Measure(EngineOperation::FILL)};
+        return Submit(order, sell_ladder_, buy_ladder_);
+    }
+    /// @brief Submit a copy of a sell order to the engine
+    /// @param order The order to sell
+    /// @return false if the order was rejected
+    bool Sell(OrderDef const& order) {
+        [[maybe_unused]] auto const timer{Measure(EngineOperation::FILL)};
+        return Submit(order, buy_ladder_, sell_ladder_);
+    }
     /// @brief Cancel an order from the book
-    /// @param id The order identifier
-    void Cancel(std::string const& id) {
-        auto index{order_book_.find(id)};
-        if(index == order_book_.end()) return;
-        auto& [_, order] = *index;
-
-        OnCancel response{order};
-        LadderDel(order);
-        order_book_.erase(index);
-        callback_(response);
-    }
-    /// @brief Revise an order's chacteristics
+    /// @param key The order's key
+    void Cancel(KeyType const& key) {
+        [[maybe_unused]] auto const timer{Measure(EngineOperation::CANCEL)};
+        auto index{order_book_.Find(key)};
+        if(!index) return;
+        Drop(**index);
+    }
+    /// @brief  Cancel every resting order of an account, stops included. The
+    ///         account's orders are unlinked in time proportional to their
+    ///         number; each is reported as a cancel, then each level touched
+    ///         is reported once.
+    /// @return The number of orders cancelled
+    std::size_t CancelAccount(std::string_view account) { return MassCancel(accounts_, account); }
+    /// @brief  Cancel every resting order that arrived on a session, as on
+    ///         disconnect. See CancelAccount.
+    /// @return The number of orders cancelled
+    std::size_t CancelSession(std::string_view session) { return MassCancel(sessions_, session); }
+    /// @brief Remove the good till date orders whose expiry time has been
+    ///        reached, each reported as a cancel. Journal the time, as an
+    ///        EXPIRE request, so replay removes the same orders.
+    /// @param now The current time
+    /// @return The number of orders removed
+    std::size_t Expire(TimePoint now) {
+        auto const tick{std::chrono::floor<ExpiryTick>(now.time_since_epoch()).count()};
+        return expiry_.Advance(tick > 0 ? static_cast<std::uint64_t>(tick) : 0,
+            [this](BookEntry& entry) { Drop(entry); });
+    }
+    /// @brief  End the trading day, removing every DAY order, stops included,
+    ///         each reported as a cancel. Each side is swept level by level:
+    ///         one level update per price touched and levels left empty are
+    ///         removed together once the sweep is done.
+    /// @return The number of orders removed
+    std::size_t PurgeDay() {
+        return Sweep(buy_ladder_, true) + Sweep(sell_ladder_, true)
+            + Sweep(buy_stops_, false) + Sweep(sell_stops_, false);
+    }
+    /// @brief Revise an order's chacteristics. A revision that keeps the
+    ///        order's side and price and does not raise its quantity keeps
+    ///        the order's place in its queue; any other is re-queued, killed
+    ///        first if it tightens a liquidity requirement that cannot be met.
+    ///        A revision whose price its ladder cannot hold, or that cannot
+    ///        rest during a call auction, is rejected and the order left as
+    ///        it was.
     /// @param order The order's new characteristics
-    void Revise(OrderRef& order) {
-        auto index{order_book_.find(order->Id())};
-        if(index == order_book_.end()) return;
-        
-        auto& [_, original_order] = *index;
-        LadderDel(original_order);
-        order_book_.erase(index);
+    void Revise(OrderRef& order) requires shared_orders {
+        [[maybe_unused]] auto const timer{Measure(EngineOperation::REVISE)};
+        if(!Keys::Fits(*order)) return;
+        auto index{order_book_.Find(Keys::Key(*order))};
+        if(!index) return;
+        if(!Priced(*order) || !Auctionable(*order)) return;
 
-        switch(order->Side()) {
-            case OrderSide::BUY:    Fill(order, sell_ladder_, buy_ladder_); break;
-            case OrderSide::SELL:   Fill(order, buy_ladder_, sell_ladder_); break;
-            default: throw std::logic_error("Order side invalid");
+        auto& entry{**index};
+        if(KeepsPriority(entry, *order)) {
+            Amend(entry, order);
+            return;
         }
-        callback_(OnRevise{order});
+        auto const screen{Tightens(*entry.order_, *order)};
+        LadderDel(entry);
+        order_book_.Erase(Keys::Key(*order));
+        Retire(entry);
+
+        Route(order, screen);
+        NotifyRevise(order);
+        ReleaseStops();
     }
+    /// @brief Revise an order's chacteristics. A revision that keeps the
+    ///        order's side and price and does not raise its quantity keeps
+    ///        the order's place in its queue; any other is re-queued, killed
+    ///        first if it tightens a liquidity requirement that cannot be met.
+    ///        A revision whose price its ladder cannot hold, or that cannot
+    ///        rest during a call auction, is rejected and the order left as
+    ///        it was.
+    /// @param order The order's new characteristics
+    /// @return false if the order is not in the book
+    bool Revise(OrderDef const& order) {
+        [[maybe_unused]] auto const timer{Measure(EngineOperation::REVISE)};
+        if(!Keys::Fits(order)) return false;
+        auto index{order_book_.Find(Keys::Key(order))};
+        if(!index) return false;
+        if(!Priced(order) || !Auctionable(order)) return true;
+
+        auto& entry{**index};
+        auto original{entry.order_};
+        if(KeepsPriority(entry, order)) {
+            auto revised{store_.Replace(original, order)};
+            if(revised != original) store_.Release(original);
+            Amend(entry, revised);
+            return true;
+        }
+        auto const screen{Tightens(*original, order)};
+        LadderDel(entry);
+        order_book_.Erase(Keys::Key(order));
+        Recycle(entry);
+
+        auto revised{store_.Replace(original, order)};
+        if(revised != original) store_.Release(original);
+
+        auto const placed{Route(revised, screen)};
+        NotifyRevise(revised);
+        if(!placed || !Rests(*revised)) store_.Release(revised);
+        ReleaseStops();
+        return true;
+    }
+
+    /// @brief Carry out a queued request
+    /// @param request The request
+    void Apply(Request& request) {
+        switch(request.action_) {
+            case EngineAction::BUY:     Buy(request.order_);    return;
+            case EngineAction::SELL:    Sell(request.order_);   return;
+            case EngineAction::CANCEL:  Cancel(request.key_);   return;
+            case EngineAction::REVISE:  Revise(request.order_); return;
+            case EngineAction::END_OF_DAY: PurgeDay();          return;
+            case EngineAction::CANCEL_ACCOUNT: CancelAccount(Payload(request.order_).Account()); return;
+            case EngineAction::CANCEL_SESSION: CancelSession(Payload(request.order_).Session()); return;
+            case EngineAction::EXPIRE: Expire(Payload(request.order_).Time()); return;
+            default: throw std::logic_error("Request action invalid");
+        }
+    }
+    /// @brief Carry out a batch of requests, signalling the end of the batch
+    ///        once all of them have been applied
+    /// @param requests The requests, applied in order
+    /// @return The number of requests applied
+    std::size_t Submit(std::span<Request> requests) {
+        for(auto& request : requests) Apply(request);
+        Flush(requests.size());
+        return requests.size();
+    }
+    /// @brief Carry out up to limit requests taken from a ring, signalling
+    ///        the end of the batch once all of them have been applied
+    /// @tparam Ring SpscRing<Request> or MpscRing<Request>
+    /// @param ring The ring to consume. The caller must be its only consumer.
+    /// @param limit The maximum number of requests to take
+    /// @return The number of requests applied
+    template<typename Ring>
+    std::size_t Drain(Ring& ring, std::size_t limit) {
+        auto const count{ring.Drain([this](Request& request) {
+            Apply(request);
+            request = Request{};
+        }, limit)};
+        if(count) Flush(count);
+        return count;
+    }
+    /// @brief Signal the end of a batch of requests
+    /// @param requests The number of requests in the batch
+    void Flush(std::size_t requests) {
+        callback_(EngineOnFlush{requests});
+    }
+    /// @brief Place a copy of an order in the book, behind the orders already
+    ///        at its price, without matching it. Used to rebuild a book.
+    /// @param order The order. It must be able to rest.
+    /// @param shown The quantity the order displays, as an iceberg part way
+    ///        through its slice does; 0 for a full slice
+    /// @return false if the order was rejected
+    /// @throw std::invalid_argument if the order cannot rest
+    /// @throw std::out_of_range if the ladder cannot hold the order's price
+    bool Restore(OrderDef const& order, std::size_t shown = 0) {
+        if(!Rests(order)) throw std::invalid_argument("Order cannot rest");
+        Validate(order);
+        if(!Identifiable(order)) return false;
+        auto admitted{store_.Admit(order)};
+        if(!admitted) {
+            callback_(OnReject{order, RejectReason::POOL_EXHAUSTED});
+            return false;
+        }
+        if(IsStop(order))                       Park(admitted);
+        else if(order.Side() == OrderSide::BUY) Rest(admitted, buy_ladder_, shown);
+        else                                    Rest(admitted, sell_ladder_, shown);
+        return true;
+    }
+    /// @brief Set the price of the last trade, as when rebuilding a book
+    void LastPrice(std::optional<PriceType> price) { last_price_ = price; }
+    /// @brief Visit every resting order: bids then offers, each side from
+    ///        best price to worst and each price in time priority, followed
+    ///        by the pending buy then sell stops in trigger order
+    /// @param visit Invoked with each order and, if it takes a second
+    ///        argument, the quantity the order displays
+    template<typename Visit>
+    void ForEachResting(Visit&& visit) const {
+        auto side = [&visit](auto const& ladder) {
+            for(auto&& [price, rung] : ladder) {
+                for(auto const& entry : rung.orders_) {
+                    auto const& order{static_cast<OrderDef const&>(*entry.order_)};
+                    if constexpr(std::is_invocable_v<Visit&, OrderDef const&, std::size_t>) {
+                        visit(order, entry.quantity_);
+                    }
+                    else {
+                        visit(order);
+                    }
+                }
+            }
+        };
+        side(buy_ladder_);
+        side(sell_ladder_);
+        side(buy_stops_);
+        side(sell_stops_);
+    }
+    /// @brief Returns the price of the last trade, if any
+    std::optional<PriceType> LastPrice() const { return last_price_; }
+    /// @brief Returns the number of resting orders
+    std::size_t Resting() const { return order_book_.Size(); }
+    /// @brief  Returns the engine's statistics. With EngineStats configured,
+    ///         a monitoring thread may take snapshots of them while the
+    ///         engine runs.
+    Stats const& Statistics() const { return stats_; }
+    /// @brief Start a call auction. Until the uncross, orders rest without
+    ///        matching; orders that cannot rest, market, IOC and FOK, are
+    ///        rejected.
+    void BeginAuction() { auction_ = true; }
+    /// @brief Indicates if a call auction is under way
+    bool InAuction() const { return auction_; }
+    /// @brief  End the call auction, executing the crossed part of the book at
+    ///         the single price that maximizes executed quantity. Ties go to
+    ///         the price leaving the smaller surplus, then to the higher price
+    ///         if buyers are in surplus and the lower one otherwise. Fills are
+    ///         reported as trades with the buy order as new_order_ and the sell
+    ///         order as existing_order_, in price then time priority.
+    /// @return The auction price and the quantity executed
+    AuctionResult<PriceType> Uncross() {
+        auction_ = false;
+        auto const result{Equilibrium()};
+        if(result.quantity_) Cross(result);
+        ReleaseStops();
+        return result;
+    }
+    /// @brief Returns the matching policy, for policies configured at run time
+    Matching& MatchingPolicy() { return matching_; }
+    /// @brief Returns the best bid, if any
+    std::optional<Level> BestBid() const { return Top(buy_ladder_); }
+    /// @brief Returns the best offer, if any
+    std::optional<Level> BestAsk() const { return Top(sell_ladder_); }
+    /// @brief Copy the best bid levels, best first
+    /// @param levels Receives up to levels.size() levels
+    /// @return The number of levels copied
+    std::size_t BidDepth(std::span<Level> levels) const { return Depth(buy_ladder_, levels); }
+    /// @brief Copy the best offer levels, best first
+    /// @param levels Receives up to levels.size() levels
+    /// @return The number of levels copied
+    std::size_t AskDepth(std::span<Level> levels) const { return Depth(sell_ladder_, levels); }
 
 private:
-    /// @brief Removes an order from a buy/sell ladder
-    /// @param order The order to remove
-    void LadderDel(OrderRef& order) {
+    static constexpr bool records{ExecutionRecorder<std::remove_reference_t<Callback>, OrderDef>};
+    /// @brief Report a fill of an incoming order against a resting order
+    void NotifyTrade(OrderRef const& order, OrderRef const& resting, PriceType price, std::size_t matched) {
+        if constexpr(records)   callback_.RecordTrade(*order, *resting, price, matched);
+        else                    callback_(OnTrade{order, resting, matched});
+    }
+    static OrderDef const& Payload(OrderDef const& order) { return order; }
+    static OrderDef const& Payload(OrderRef const& order) requires shared_orders { return *order; }
+    /// @brief Report the removal of an order from the book
+    void NotifyCancel(OrderRef const& order) {
+        if constexpr(records) {
+            callback_.RecordCancel(*order);
+        }
+        else {
+            OnCancel response{order};
+            callback_(response);
+        }
+    }
+    /// @brief Report the revision of an order
+    void NotifyRevise(OrderRef const& order) {
+        if constexpr(records)   callback_.RecordRevise(*order);
+        else                    callback_(OnRevise{order});
+    }
+    /// @brief Report an order coming to rest in the book. Only recorders are told.
+    void NotifyRest(OrderRef const& order) {
+        if constexpr(records) callback_.RecordRest(*order);
+    }
+    template<typename Ladder>
+    static std::optional<Level> Top(Ladder const& ladder) {
+        if(ladder.Empty()) return std::nullopt;
+        auto const& rung{ladder.Best()};
+        return Level{rung.price_, rung.quantity_, rung.orders_.Size()};
+    }
+    template<typename Ladder>
+    static std::size_t Depth(Ladder const& ladder, std::span<Level> levels) {
+        std::size_t count{};
+        for(auto&& [price, rung] : ladder) {
+            if(count == levels.size()) break;
+            levels[count++] = Level{price, rung.quantity_, rung.orders_.Size()};
+        }
+        return count;
+    }
+    /// @brief Report the aggregate of a rung after it changed
+    template<typename Ladder>
+    void NotifyLevel(Ladder const&, PriceRung const& rung) {
+        constexpr auto side{std::is_same_v<Ladder, BuyLadder> ? OrderSide::BUY : OrderSide::SELL};
+        callback_(OnLevel{side, Level{rung.price_, rung.quantity_, rung.orders_.Size()}});
+    }
+    /// @brief Returns the quantity a rung's orders can execute, icebergs'
+    ///        reserves included, where its aggregate counts what they display
+    static std::size_t Total(PriceRung const& rung) {
+        std::size_t quantity{};
+        for(auto const& entry : rung.orders_) quantity += entry.order_->Quantity();
+        return quantity;
+    }
+    /// @brief Find the auction price in a single pass over the cumulative
+    ///        quantities, reserves included, of the levels that lie in the
+    ///        crossed range
+    AuctionResult<PriceType> Equilibrium() {
+        if(buy_ladder_.Empty() || sell_ladder_.Empty()) return {};
+        auto const high{buy_ladder_.BestPrice()};
+        auto const low{sell_ladder_.BestPrice()};
+        if(high < low) return {};
+
+        //  cumulative offered quantity at or below each offer price
+        crossing_.clear();
+        std::size_t offered{};
+        for(auto&& [price, rung] : sell_ladder_) {
+            if(price > high) break;
+            offered += Total(rung);
+            crossing_.push_back({price, offered});
+        }
+
+        //  walk the bid and offer prices from high to low
+        AuctionResult<PriceType> best{};
+        std::size_t best_surplus{};
+        std::size_t bid{};
+        auto bids{buy_ladder_.begin()};
+        auto ask{crossing_.size()};
+        for(;;) {
+            auto const bid_open{bids != buy_ladder_.end() && !((*bids).first < low)};
+            if(!bid_open && ask == 0) break;
+
+            PriceType price{};
+            if(!bid_open)                                       price = crossing_[ask - 1].price_;
+            else if(ask == 0 || crossing_[ask - 1].price_ < (*bids).first) price = (*bids).first;
+            else                                                price = crossing_[ask - 1].price_;
+
+            if(bid_open && (*bids).first == price) {
+                bid += Total((*bids).second);
+                ++bids;
+            }
+            auto const ask_total{ask ? crossing_[ask - 1].quantity_ : 0};
+            if(ask && crossing_[ask - 1].price_ == price) --ask;
+
+            auto const volume{std::min(bid, ask_total)};
+            auto const surplus{std::max(bid, ask_total) - volume};
+            if(volume > best.quantity_
+                || (volume && volume == best.quantity_ && surplus < best_surplus)
+                || (volume && volume == best.quantity_ && surplus == best_surplus && bid < ask_total)) {
+                best = {price, volume};
+                best_surplus = surplus;
+            }
+        }
+        return best;
+    }
+    /// @brief Execute an auction at its equilibrium
+    void Cross(AuctionResult<PriceType> const& auction) {
+        auto remaining{auction.quantity_};
+        auto consume = [](PriceRung& rung, BookEntry& entry, std::size_t matched) {
+            entry.quantity_ -= matched;
+            rung.quantity_ -= matched;
+            entry.order_->Quantity(entry.order_->Quantity() - matched);
+        };
+        //  returns false once the rung is emptied, reported and removed
+        auto settle = [this](auto& ladder, PriceRung& rung, BookEntry& entry) {
+            if(entry.quantity_) return true;
+            rung.orders_.PopFront();
+            if(entry.order_->Quantity()) {
+                Replenish(rung, entry);
+                return true;
+            }
+            order_book_.Erase(Keys::Key(*entry.order_));
+            Retire(entry);
+            if(!rung.orders_.Empty()) return true;
+            NotifyLevel(ladder, rung);
+            ladder.Erase(rung.price_);
+            return false;
+        };
+        while(remaining) {
+            auto& bid_rung{buy_ladder_.Best()};
+            auto& ask_rung{sell_ladder_.Best()};
+            auto& bid{bid_rung.orders_.Front()};
+            auto& ask{ask_rung.orders_.Front()};
+            auto const matched{std::min({remaining, bid.quantity_, ask.quantity_})};
+            remaining -= matched;
+            last_price_ = auction.price_;
+
+            consume(bid_rung, bid, matched);
+            consume(ask_rung, ask, matched);
+            NotifyTrade(bid.order_, ask.order_, auction.price_, matched);
+
+            //  a rung left in the book is reported once the crossing is done
+            auto const last{remaining == 0};
+            if(settle(buy_ladder_, bid_rung, bid) && last)  NotifyLevel(buy_ladder_, bid_rung);
+            if(settle(sell_ladder_, ask_rung, ask) && last) NotifyLevel(sell_ladder_, ask_rung);
+        }
+    }
+    /// @brief Indicates if a revision may keep a resting order's place in
+    ///        its queue: neither it nor the revision a stop, same side and
+    ///        price, no more quantity, and still resting
+    static bool KeepsPriority(BookEntry const& entry, OrderDef const& revised) {
+        return !IsStop(*entry.order_) && !IsStop(revised)
+            && (revised.Side() == entry.order_->Side())
+            && (revised.Price() == entry.rung_->price_)
+            && (Shown(revised) <= entry.quantity_)
+            && (revised.Quantity() <= std::max(entry.quantity_, entry.order_->Quantity()))
+            && Rests(revised);
+    }
+    /// @brief Apply a revision to a resting order in place
+    /// @param entry The order's book entry
+    /// @param revised The revised order
+    void Amend(BookEntry& entry, OrderRef const& revised) {
+        auto& rung{*entry.rung_};
+        auto const shown{Shown(*revised)};
+        rung.quantity_ -= entry.quantity_ - shown;
+        entry.quantity_ = shown;
+        entry.order_ = revised;
+        Schedule(entry);
+        Enlist(entry);
+        if(revised->Side() == OrderSide::BUY)   NotifyLevel(buy_ladder_, rung);
+        else                                    NotifyLevel(sell_ladder_, rung);
+        NotifyRevise(revised);
+    }
+    /// @brief Returns the quantity of an order displayed in its rung: all of
+    ///        it, or an iceberg's display slice
+    static std::size_t Shown(OrderDef const& order) {
+        return (order.MaxShow() && order.MaxShow() < order.Quantity()) ? order.MaxShow() : order.Quantity();
+    }
+    /// @brief Refill an iceberg's display slice from its reserve, sending it
+    ///        to the back of its rung
+    /// @param rung The rung
+    /// @param entry The iceberg's entry, already removed from the rung
+    static void Replenish(PriceRung& rung, BookEntry& entry) {
+        if(rung.top_ == &entry) rung.top_ = nullptr;
+        entry.quantity_ = Shown(*entry.order_);
+        rung.quantity_ += entry.quantity_;
+        rung.orders_.PushBack(entry);
+    }
+    /// @brief Indicates if an order waits in the trigger book
+    static bool IsStop(OrderDef const& order) {
+        return order.Type() == OrderType::STOP || order.Type() == OrderType::STOP_LIMIT;
+    }
+    /// @brief Indicates if the last trade price has reached a stop's trigger
+    bool Triggered(OrderDef const& order) const {
+        if(!last_price_) return false;
+        return (order.Side() == OrderSide::BUY) ? !(*last_price_ < order.StopPrice())
+                                                : !(order.StopPrice() < *last_price_);
+    }
+    /// @brief Turn a triggered stop into the order it releases
+    static void Activate(OrderDef& order) {
+        order.Type(order.Type() == OrderType::STOP ? OrderType::MARKET : OrderType::LIMIT);
+    }
+    /// @brief Release the stops triggered by the last trade price, best
+    ///        trigger first, sending each through the book in turn. Trades
+    ///        made by released stops move the last price and may release
+    ///        further stops. A stop limit whose price its ladder can no
+    ///        longer hold is rejected instead.
+    void ReleaseStops() {
+        if(releasing_ || auction_ || !last_price_) return;
+        releasing_ = true;
+        RAII done{[this]() { releasing_ = false; }};
+
+        for(;;) {
+            PriceRung* rung{};
+            if(!buy_stops_.Empty() && !(*last_price_ < buy_stops_.BestPrice()))          rung = &buy_stops_.Best();
+            else if(!sell_stops_.Empty() && !(sell_stops_.BestPrice() < *last_price_))   rung = &sell_stops_.Best();
+            if(!rung) return;
+
+            auto& entry{rung->orders_.Front()};
+            OrderRef order{entry.order_};
+            auto const accepted{Accepted(*order)};
+            LadderDel(entry);
+            order_book_.Erase(Keys::Key(*order));
+            Recycle(entry);
+            if(!accepted) {
+                callback_(OnReject{*order, RejectReason::PRICE_OUT_OF_RANGE});
+                store_.Release(order);
+                continue;
+            }
+
+            Activate(*order);
+            callback_(OnTrigger{order});
+            if(!Route(order, true) || !Rests(*order)) store_.Release(order);
+        }
+    }
+    /// @brief Place a stop in the trigger book
+    void Park(OrderRef const& order) {
+        auto& entry{Enter(order)};
+        auto& rung{(order->Side() == OrderSide::BUY) ? buy_stops_[order->StopPrice()]
+                                                     : sell_stops_[order->StopPrice()]};
+        rung.price_ = order->StopPrice();
+        Attach(entry, rung, order);
+    }
+    /// @brief Returns the quantity an order requires to execute on arrival:
+    ///        all of it for FOK, its minimum quantity if it has one, else 0
+    static std::size_t Required(OrderDef const& order) {
+        if(order.TIF() == OrderTimeInForce::FOK) return order.Quantity();
+        return std::min(order.MinQty(), order.Quantity());
+    }
+    /// @brief Indicates if a revision asks more of the book than the order
+    ///        it revises: it becomes fill-or-kill or raises its minimum quantity
+    static bool Tightens(OrderDef const& original, OrderDef const& revised) {
+        return (revised.TIF() == OrderTimeInForce::FOK && original.TIF() != OrderTimeInForce::FOK)
+            || (revised.MinQty() > original.MinQty());
+    }
+    /// @brief Indicates if enough displayed quantity crosses an order to
+    ///        satisfy what it requires. Reads level aggregates only; nothing
+    ///        in the book is changed.
+    /// @param order The order
+    /// @param compare The opposing ladder
+    template<typename Compare>
+    bool Executable(OrderDef const& order, Compare const& compare) const {
+        auto const required{Required(order)};
+        if(required == 0 || IsStop(order) || auction_) return true;
+
+        using Before = Compare::CompareType;
+        auto const market{order.Type() == OrderType::MARKET};
+        std::size_t available{};
+        for(auto&& [price, rung] : compare) {
+            if(!market && Before{}(order.Price(), price)) break;
+            available += rung.quantity_;
+            if(available >= required) return true;
+        }
+        return false;
+    }
+    /// @brief  Indicates if an order's identifier can key it in the book,
+    ///         keys no order already there and, given an execution recorder,
+    ///         can be recorded in full, rejecting the order if not. Checked
+    ///         on arrival so nothing that files the order away can fail part
+    ///         way through or displace another order.
+    bool Identifiable(OrderDef const& order) {
+        auto recordable{true};
+        if constexpr(records) recordable = callback_.Fits(order);
+        if(!recordable || !Keys::Fits(order)) {
+            callback_(OnReject{order, RejectReason::INVALID_ID});
+            return false;
+        }
+        if(!order_book_.Find(Keys::Key(order))) return true;
+        callback_(OnReject{order, RejectReason::DUPLICATE_ID});
+        return false;
+    }
+    /// @brief  Indicates if an order can enter the book, rejecting it if not:
+    ///         during a call auction only orders that can rest until the
+    ///         uncross are accepted
+    bool Auctionable(OrderDef const& order) {
+        if(!auction_ || IsStop(order) || Rests(order)) return true;
+        callback_(OnReject{order, RejectReason::AUCTION});
+        return false;
+    }
+    /// @brief Indicates if what remains of an order rests in the book
+    static bool Rests(OrderDef const& order) {
+        if(IsStop(order)) return order.Quantity() != 0;
+        return (order.Type() != OrderType::MARKET)
+            && (order.TIF() != OrderTimeInForce::IOC)
+            && (order.TIF() != OrderTimeInForce::FOK)
+            && (order.Quantity() != 0);
+    }
+    /// @brief Check that an order could rest in its ladder
+    /// @throw std::out_of_range if the ladder cannot hold the order's price
+    void Validate(OrderDef const& order) const {
+        if(!Accepted(order)) throw std::out_of_range("Order price outside ladder range");
+    }
+    /// @brief Indicates if an order could rest in its ladder, rejecting the
+    ///        order if not
+    bool Priced(OrderDef const& order) {
+        if(Accepted(order)) return true;
+        callback_(OnReject{order, RejectReason::PRICE_OUT_OF_RANGE});
+        return false;
+    }
+    /// @brief Indicates if an order could rest in its ladder
+    bool Accepted(OrderDef const& order) const {
+        switch(order.Side()) {
+            case OrderSide::BUY:    return Accepted(order, buy_ladder_);
+            case OrderSide::SELL:   return Accepted(order, sell_ladder_);
+            default: throw std::logic_error("Order side invalid");
+        }
+    }
+    template<typename Ladder>
+    static bool Accepted(OrderDef const& order, Ladder const& ladder) {
+        return (order.Type() != OrderType::LIMIT && order.Type() != OrderType::STOP_LIMIT)
+            || (order.TIF() == OrderTimeInForce::IOC)
+            || (order.TIF() == OrderTimeInForce::FOK)
+            || ladder.Accepts(order.Price());
+    }
+    /// @brief Fill an order against the opposing side of the book
+    /// @param order The order to fill
+    /// @param screen Indicates the order's fill-or-kill or minimum quantity
+    ///        applies: it arrives, or a revision tightened it
+    /// @return false if the order was killed for lack of liquidity
+    bool Route(OrderRef& order, bool screen) {
         switch(order->Side()) {
-            case OrderSide::BUY:    LadderDel(order, buy_ladder_);  return;
-            case OrderSide::SELL:   LadderDel(order, sell_ladder_); return;
+            case OrderSide::BUY:    return Fill(order, sell_ladder_, buy_ladder_, screen);
+            case OrderSide::SELL:   return Fill(order, buy_ladder_, sell_ladder_, screen);
+            default: throw std::logic_error("Order side invalid");
+        }
+    }
+    /// @brief Admit a copy of an order into the store and fill it
+    /// @return false if the order was rejected: for its price or identifier,
+    ///         as it cannot rest during an auction, for lack of liquidity or
+    ///         by the store
+    template<typename Compare, typename Store>
+    bool Submit(OrderDef const& order, Compare& compare, Store& store) {
+        if(!Priced(order) || !Identifiable(order) || !Auctionable(order)) return false;
+        if(!Executable(order, compare)) {
+            callback_(OnReject{order, RejectReason::INSUFFICIENT_LIQUIDITY});
+            return false;
+        }
+        auto admitted{store_.Admit(order)};
+        if(!admitted) {
+            callback_(OnReject{order, RejectReason::POOL_EXHAUSTED});
+            return false;
+        }
+
+        //  screened above; a stop is screened as it triggers
+        Fill(admitted, compare, store, false);
+        if(!Rests(*admitted)) store_.Release(admitted);
+        ReleaseStops();
+        return true;
+    }
+    /// @brief Return a book entry, and the order it holds, to their stores
+    /// @param entry The entry, already removed from the book and its rung
+    void Retire(BookEntry& entry) {
+        store_.Release(entry.order_);
+        Recycle(entry);
+    }
+    /// @brief Return a book entry to its store
+    /// @param entry The entry, already removed from the book and its rung
+    void Recycle(BookEntry& entry) {
+        if(entry.rung_ && entry.rung_->top_ == &entry) entry.rung_->top_ = nullptr;
+        expiry_.Cancel(entry);
+        Delist(entry.account_, entry);
+        Delist(entry.session_, entry);
+        entries_.Release(&entry);
+    }
+    /// @brief Add an entry to the orders of its order's account and session
+    void Enlist(BookEntry& entry) {
+        Enlist(accounts_, entry.account_, entry.order_->Account(), entry);
+        Enlist(sessions_, entry.session_, entry.order_->Session(), entry);
+    }
+    /// @brief Move an entry to the orders of an owner, unless already there
+    /// @param owners The owners of a kind
+    /// @param owner The entry's current owner of that kind, if any
+    /// @param name The owner the entry belongs to; empty for none
+    template<typename Owners>
+    static void Enlist(Owners& owners, typename Owners::value_type*& owner, std::string_view name,
+        BookEntry& entry) {
+        if(owner && owner->first == name) return;
+        Delist(owner, entry);
+        if(name.empty()) return;
+        auto index{owners.find(name)};
+        if(index == owners.end()) index = owners.try_emplace(std::string(name)).first;
+        owner = &*index;
+        owner->second.PushBack(entry);
+    }
+    template<typename Owner>
+    static void Delist(Owner*& owner, BookEntry& entry) {
+        if(!owner) return;
+        owner->second.Erase(entry);
+        owner = nullptr;
+    }
+    /// @brief Cancel every order of an owner
+    template<typename Owners>
+    std::size_t MassCancel(Owners& owners, std::string_view name) {
+        auto index{owners.find(name)};
+        if(index == owners.end()) return 0;
+        auto& orders{index->second};
+
+        std::size_t count{};
+        touched_.clear();
+        while(!orders.Empty()) {
+            auto& entry{orders.Front()};
+            if(IsStop(*entry.order_)) {
+                LadderDel(entry);
+            }
+            else {
+                auto& rung{*entry.rung_};
+                rung.quantity_ -= entry.quantity_;
+                rung.orders_.Erase(entry);
+                touched_.push_back({&rung, entry.order_->Side()});
+            }
+            order_book_.Erase(Keys::Key(*entry.order_));
+            NotifyCancel(entry.order_);
+            Retire(entry);
+            ++count;
+        }
+        Settle();
+        return count;
+    }
+    /// @brief Report each level touched by a mass cancel once, removing the
+    ///        levels left empty
+    void Settle() {
+        auto before = [](auto const& lhs, auto const& rhs) { return std::less<PriceRung*>{}(lhs.first, rhs.first); };
+        auto same = [](auto const& lhs, auto const& rhs) { return lhs.first == rhs.first; };
+        std::sort(touched_.begin(), touched_.end(), before);
+        touched_.erase(std::unique(touched_.begin(), touched_.end(), same), touched_.end());
+
+        auto settle = [this](auto& ladder, PriceRung& rung) {
+            NotifyLevel(ladder, rung);
+            if(rung.orders_.Empty()) ladder.Erase(rung.price_);
+        };
+        for(auto [rung, side] : touched_) {
+            if(side == OrderSide::BUY)  settle(buy_ladder_, *rung);
+            else                        settle(sell_ladder_, *rung);
+        }
+    }
+    /// @brief Remove a resting order from the book, reporting it as cancelled
+    void Drop(BookEntry& entry) {
+        LadderDel(entry);
+        order_book_.Erase(Keys::Key(*entry.order_));
+        NotifyCancel(entry.order_);
+        Retire(entry);
+    }
+    /// @brief Remove the DAY orders of a ladder
+    /// @param ladder The ladder
+    /// @param levels Indicates if the ladder's level changes are reported
+    /// @return The number of orders removed
+    template<typename Ladder>
+    std::size_t Sweep(Ladder& ladder, bool levels) {
+        std::size_t count{};
+        emptied_.clear();
+        for(auto&& [price, rung] : ladder) {
+            auto const before{count};
+            for(auto next{rung.orders_.begin()}; next != rung.orders_.end();) {
+                auto& entry{*next++};
+                if(entry.order_->TIF() != OrderTimeInForce::DAY) continue;
+                rung.quantity_ -= entry.quantity_;
+                rung.orders_.Erase(entry);
+                order_book_.Erase(Keys::Key(*entry.order_));
+                NotifyCancel(entry.order_);
+                Retire(entry);
+                ++count;
+            }
+            if(count == before) continue;
+            if(levels) NotifyLevel(ladder, rung);
+            if(rung.orders_.Empty()) emptied_.push_back(price);
+        }
+        for(auto price : emptied_) ladder.Erase(price);
+        return count;
+    }
+    /// @brief Place a good till date order's entry in the expiry wheel, or
+    ///        take any other order's out of it
+    void Schedule(BookEntry& entry) {
+        expiry_.Cancel(entry);
+        if(entry.order_->TIF() != OrderTimeInForce::GTD) return;
+        auto const tick{std::chrono::ceil<ExpiryTick>(entry.order_->ExpireTime().time_since_epoch()).count()};
+        expiry_.Schedule(entry, tick > 0 ? static_cast<std::uint64_t>(tick) : 0);
+    }
+    /// @brief Removes a resting order from its price rung, removing the rung
+    ///        from its ladder once empty
+    /// @param entry The book entry of the order to remove
+    void LadderDel(BookEntry& entry) {
+        auto& rung{*entry.rung_};
+        rung.quantity_ -= entry.quantity_;
+        rung.orders_.Erase(entry);
+        auto remove = [&rung](auto& ladder) {
+            if(rung.orders_.Empty()) ladder.Erase(rung.price_);
+        };
+        if(IsStop(*entry.order_)) {
+            if(entry.order_->Side() == OrderSide::BUY)  remove(buy_stops_);
+            else                                        remove(sell_stops_);
+            return;
+        }
+        switch(entry.order_->Side()) {
+            case OrderSide::BUY:    NotifyLevel(buy_ladder_, rung);  remove(buy_ladder_);  return;
+            case OrderSide::SELL:   NotifyLevel(sell_ladder_, rung); remove(sell_ladder_); return;
             default:    throw std::logic_error("Order side invalid");
         }
     }
-    /// @brief Removes an order from the indicated ladder
-    /// @tparam Ladder Type of ladder (buy/sell)
-    /// @param order The order to remove
-    /// @param ladder The ladder to update
+    /// @brief Place an order at the back of its price rung
+    /// @param order The order
+    /// @param ladder The ladder of the order's side
+    /// @param shown The quantity the order displays; 0 for a full slice
     template<typename Ladder>
-    void LadderDel(OrderRef& order, Ladder& ladder) {
-        auto& rung = ladder[order->Price()];
-        auto index = std::find_if(rung.begin(), rung.end(),
-            [&id = order->Id()](auto&& index) noexcept {
-                return id == index->Id();
-            });
-        if(index != rung.end()) rung.erase(index);
+    void Rest(OrderRef const& order, Ladder& ladder, std::size_t shown = 0) {
+        auto& entry{Enter(order)};
+        auto& rung{ladder[order->Price()]};
+        auto const fresh{rung.orders_.Empty()};
+        rung.price_ = order->Price();
+        Attach(entry, rung, order, shown);
+        if(fresh) rung.top_ = (&ladder.Best() == &rung) ? &entry : nullptr;
+        NotifyLevel(ladder, rung);
+        NotifyRest(order);
+    }
+    /// @brief Provide a book entry for an order. No order with the same key
+    ///        rests: arrivals carrying one are rejected as duplicates.
+    BookEntry& Enter(OrderRef const& order) {
+        auto [index, _] = order_book_.TryEmplace(Keys::Key(*order));
+        auto& entry{*entries_.Acquire()};
+        *index = &entry;
+        return entry;
+    }
+    /// @brief Append an order's entry to the back of a rung, listing it under
+    ///        its account and session and scheduling its expiry if it is
+    ///        good till date
+    /// @param shown The quantity the order displays; 0 for a full slice
+    void Attach(BookEntry& entry, PriceRung& rung, OrderRef const& order, std::size_t shown = 0) {
+        entry.order_ = order;
+        entry.rung_ = &rung;
+        entry.quantity_ = shown ? std::min(shown, Shown(*order)) : Shown(*order);
+        rung.quantity_ += entry.quantity_;
+        rung.orders_.PushBack(entry);
+        Schedule(entry);
+        Enlist(entry);
     }
     /// @brief RAII helper based on a funtion
     /// @tparam Action The function type
@@ -146,62 +1095,120 @@ private:
     private:
         Action action_;
     };
-    /// @brief Fill an order from existing orders
+    /// @brief Fill an order from existing orders. A stop that has not been
+    ///        triggered is parked in the trigger book instead. An arriving
+    ///        order, or a stop as it triggers, whose fill-or-kill or minimum
+    ///        quantity cannot be met is killed before anything in the book is
+    ///        touched; a re-queued order is screened again only if its
+    ///        revision tightened the requirement.
     /// @tparam Compare Price ladder containing opposing orders
     /// @tparam Store Price ladder to store the order in if not fully filled
     /// @param order The order to fill
     /// @param compare The price ladder to fill the order from
     /// @param store Where to store the unfilled order
+    /// @param screen Indicates the order's liquidity requirement applies
+    /// @return false if the order was killed
     template<typename Compare, typename Store>
-    void Fill(OrderRef& order, Compare& compare, Store& store) {
-
-        auto wrapup = [this, &order, &ladder=store]() {
-            if((order->Type() == OrderType::MARKET)
-                || (order->TIF() == OrderTimeInForce::IOC)
-                || (order->Quantity() == 0)) return;
-            ladder[order->Price()].push_back(order);
-            order_book_[order->Id()] = order;
-        };
-
-        RAII finally{wrapup};
-
-        if(compare.empty()) return;
+    bool Fill(OrderRef& order, Compare& compare, Store& store, bool screen) {
+        if(IsStop(*order)) {
+            if(auction_ || !Triggered(*order)) {
+                if(order->Quantity()) Park(order);
+                return true;
+            }
+            Activate(*order);
+            callback_(OnTrigger{order});
+            screen = true;
+        }
+        if(screen && !Executable(*order, compare)) {
+            callback_(OnReject{*order, RejectReason::INSUFFICIENT_LIQUIDITY});
+            return false;
+        }
 
+        if(!auction_ && !compare.Empty()) Match(order, compare);
+        if(Rests(*order)) Rest(order, store);
+        return true;
+    }
+    /// @brief Match an order against the opposing side of the book until it
+    ///        is filled or no longer crosses
+    /// @param order The order to match
+    /// @param compare The price ladder to match the order against
+    template<typename Compare>
+    void Match(OrderRef& order, Compare& compare) {
         auto remaining{order->Quantity()};
         auto target_price{order->Price()};
         if(order->Type() == OrderType::MARKET) {
-            target_price = compare.rbegin()->first;
+            target_price = compare.WorstPrice();
         }
 
-        for(auto& [price, rung] : compare) {
-            if(remaining == 0) break;
-            if(compare.key_comp()(target_price, price)) break;
-
-            while(remaining && !rung.empty()) {
-                auto& rung_order{rung.front()};
-                auto quantity{rung_order->Quantity()};
-                auto const matched{std::min(remaining, quantity)};
+        using Before = Compare::CompareType;
+        std::size_t swept{};
+        while(remaining && !compare.Empty()) {
+            auto& rung{compare.Best()};
+            if(Before{}(target_price, rung.price_)) break;
+            ++swept;
 
+            auto& orders{rung.orders_};
+            auto execute = [&](BookEntry& rung_entry, std::size_t matched) {
+                auto& rung_order{rung_entry.order_};
                 remaining -= matched;
-                quantity -= matched;
-
                 order->Quantity(remaining);
-                rung_order->Quantity(quantity);
+                rung_order->Quantity(rung_order->Quantity() - matched);
+                rung_entry.quantity_ -= matched;
+                rung.quantity_ -= matched;
 
-                callback_(OnTrade{order, rung_order, matched});
+                NotifyTrade(order, rung_order, rung.price_, matched);
+                last_price_ = rung.price_;
+                stats_.Filled();
 
-                if(quantity == 0) {
-                    order_book_.erase(rung_order->Id());
-                    rung.pop_front();
+                if(rung_entry.quantity_) return;
+                orders.Erase(rung_entry);
+                if(rung_order->Quantity()) {
+                    Replenish(rung, rung_entry);
+                    return;
                 }
-            }
+                order_book_.Erase(Keys::Key(*rung_order));
+                Retire(rung_entry);
+            };
+            matching_.Allocate(rung, remaining, execute);
+
+            NotifyLevel(compare, rung);
+            if(orders.Empty()) compare.Erase(rung.price_);
         }
+        stats_.Swept(swept);
+    }
+    /// @brief  Start timing an operation, the size of the book to be
+    ///         published once it completes. Free unless statistics are
+    ///         configured.
+    auto Measure(EngineOperation operation) {
+        return stats_.Start(operation, [this] {
+            return std::pair<std::uint64_t, std::uint64_t>{order_book_.Size(),
+                buy_ladder_.Size() + sell_ladder_.Size()};
+        });
     }
 
 private:
-    OrderBook order_book_{};
+    OrderBook order_book_{Keys::reserve};
     BuyLadder buy_ladder_{};
     SellLadder sell_ladder_{};
+    OrderStore store_{};
+    ObjectPool<BookEntry> entries_{Config::entry_slab_size};
     Callback callback_;
+    bool auction_{};
+    BuyStops buy_stops_{};
+    SellStops sell_stops_{};
+    std::optional<PriceType> last_price_{};
+    bool releasing_{};
+    /// @brief Cumulative offered quantity by price, kept between auctions
+    std::vector<AuctionResult<PriceType>> crossing_{};
+    /// @brief Good till date orders by expiry tick
+    TimingWheel<BookEntry> expiry_{};
+    /// @brief Prices of the levels emptied by a sweep, kept between sweeps
+    std::vector<PriceType> emptied_{};
+    Accounts accounts_{};
+    Sessions sessions_{};
+    [[no_unique_address]] Matching matching_{};
+    [[no_unique_address]] Stats stats_{};
+    /// @brief The levels touched by a mass cancel, kept between mass cancels
+    std::vector<std::pair<PriceRung*, OrderSide>> touched_{};
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,135 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <FixedId.h>
+
+#include    <algorithm>
+#include    <cstddef>
+#include    <functional>
+#include    <string>
+#include    <string_view>
+#include    <unordered_set>
+#include    <utility>
+
+namespace pentifica::trd::exch {
+//  Matching policies decide how an incoming quantity is shared among
+//  the orders resting at a price. A policy is selected at compile time
+//  through EngineConfig::Matching and held by the engine, so allocation is
+//  resolved without virtual dispatch. A policy provides
+//
+//      std::size_t Allocate(Rung& rung, std::size_t quantity, Execute&& execute)
+//
+//  which calls execute(entry, matched) for each fill, in the order the
+//  fills happen, and returns the quantity allocated. It must allocate
+//  all of quantity unless the level runs out of orders. A filled entry
+//  leaves the level, or, if it is an iceberg with reserve, moves to
+//  the back of it with a fresh display slice, during execute.
+
+/// @brief Allocate in time priority: each order is filled in full before the
+///        next is touched
+struct FifoMatching {
+    template<typename Rung, typename Execute>
+    std::size_t Allocate(Rung& rung, std::size_t quantity, Execute&& execute) {
+        auto remaining{quantity};
+        while(remaining && !rung.orders_.Empty()) {
+            auto& entry{rung.orders_.Front()};
+            auto const matched{std::min(remaining, entry.quantity_)};
+            remaining -= matched;
+            execute(entry, matched);
+        }
+        return quantity - remaining;
+    }
+};
+/// @brief  Allocate in proportion to each order's displayed quantity, rounded
+///         down, with what rounding leaves over allocated in time priority.
+///         A quantity that takes the whole level is allocated in time priority.
+struct ProRataMatching {
+    template<typename Rung, typename Execute>
+    std::size_t Allocate(Rung& rung, std::size_t quantity, Execute&& execute) {
+        auto const total{rung.quantity_};
+        if(quantity >= total) return FifoMatching{}.Allocate(rung, quantity, execute);
+
+        std::size_t allocated{};
+        auto next{rung.orders_.begin()};
+        for(auto count{rung.orders_.Size()}; count; --count) {
+            auto& entry{*next++};
+            auto const share{static_cast<std::size_t>(
+                static_cast<unsigned __int128>(quantity) * entry.quantity_ / total)};
+            if(share == 0) continue;
+            allocated += share;
+            execute(entry, share);
+        }
+        return allocated + FifoMatching{}.Allocate(rung, quantity - allocated, execute);
+    }
+};
+/// @brief  The top order, the order that set a new best price, is filled
+///         first for as long as it stays at the front of its level; the
+///         rest is allocated by Base
+/// @tparam Base The policy allocating what the top order does not take
+template<typename Base = ProRataMatching>
+struct TopOrderMatching {
+    template<typename Rung, typename Execute>
+    std::size_t Allocate(Rung& rung, std::size_t quantity, Execute&& execute) {
+        std::size_t allocated{};
+        if(rung.top_ && quantity && rung.top_ == &rung.orders_.Front()) {
+            allocated = std::min(quantity, rung.top_->quantity_);
+            execute(*rung.top_, allocated);
+        }
+        return allocated + base_.Allocate(rung, quantity - allocated, execute);
+    }
+
+    Base base_{};
+};
+/// @brief  Orders of lead market makers are allocated up to Percent of the
+///         incoming quantity, in time priority, before the rest is allocated
+///         by Base, in which they take part again. Market makers are
+///         designated by account.
+/// @tparam Percent The share of each allocation reserved for market makers
+/// @tparam Base The policy allocating what market makers do not take
+template<std::size_t Percent, typename Base = ProRataMatching>
+class LmmMatching {
+    static_assert(Percent <= 100, "Percent must not exceed 100");
+public:
+    /// @brief Designate an account as a lead market maker
+    void AddMaker(std::string account) { makers_.insert(std::move(account)); }
+    /// @brief Withdraw an account's lead market maker designation
+    void RemoveMaker(std::string const& account) { makers_.erase(account); }
+    bool IsMaker(std::string_view account) const { return makers_.contains(account); }
+
+    template<typename Rung, typename Execute>
+    std::size_t Allocate(Rung& rung, std::size_t quantity, Execute&& execute) {
+        std::size_t allocated{};
+        auto const entitled{quantity * Percent / 100};
+        auto next{rung.orders_.begin()};
+        for(auto count{makers_.empty() ? 0 : rung.orders_.Size()}; count && allocated < entitled; --count) {
+            auto& entry{*next++};
+            if(!IsMaker(entry.order_->Account())) continue;
+            auto const matched{std::min(entitled - allocated, entry.quantity_)};
+            allocated += matched;
+            execute(entry, matched);
+        }
+        return allocated + base_.Allocate(rung, quantity - allocated, execute);
+    }
+
+private:
+    std::unordered_set<std::string, IdHash, std::equal_to<>> makers_{};
+    Base base_{};
+};
+}
@@ -0,0 +1,121 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <algorithm>
+#include    <cstddef>
+#include    <functional>
+#include    <memory>
+#include    <new>
+#include    <stdexcept>
+#include    <utility>
+#include    <vector>
+
+namespace pentifica::trd::exch {
+/// @brief Identifies what a pool does once all of its objects are in use
+enum class PoolExhaustion:char {GROW = 'G', REJECT = 'R'};
+/// @brief  A pool of objects carved from preallocated slabs. Released objects
+///         are threaded onto a free list and handed out again, so once the
+///         pool has reached its working size no further allocation occurs.
+///         A free object's storage holds the free list link, so each object
+///         occupies exactly sizeof(T) and keeps the alignment of T.
+/// @tparam T The pooled object type
+template<typename T>
+class ObjectPool {
+public:
+    /// @brief Prepare a pool with one slab preallocated
+    /// @param slab_size The number of objects per slab
+    /// @param policy What to do when every object is in use
+    explicit ObjectPool(std::size_t slab_size, PoolExhaustion policy = PoolExhaustion::GROW) :
+        slab_size_{slab_size},
+        policy_{policy}
+    {
+        if(slab_size_ == 0) throw std::invalid_argument("slab_size == 0");
+        AddSlab();
+    }
+    ObjectPool(ObjectPool const&) = delete;
+    ObjectPool(ObjectPool&&) = delete;
+    ~ObjectPool() {
+        std::vector<Slot const*> free;
+        free.reserve(Capacity() - in_use_);
+        for(auto* slot{free_}; slot; slot = slot->next_) free.push_back(slot);
+        std::sort(free.begin(), free.end(), std::less<>{});
+        for(auto& slab : slabs_) {
+            for(std::size_t index = 0; index < slab_size_; ++index) {
+                auto& slot{slab[index]};
+                if(!std::binary_search(free.begin(), free.end(), &slot, std::less<>{})) slot.Object()->~T();
+            }
+        }
+    }
+    ObjectPool& operator=(ObjectPool const&) = delete;
+    ObjectPool& operator=(ObjectPool&&) = delete;
+    /// @brief Construct an object from the pool
+    /// @param args Arguments forwarded to the object's constructor
+    /// @return The object or nullptr if the pool is exhausted and may not grow
+    template<typename ...Args>
+    T* Acquire(Args&& ...args) {
+        if(!free_) {
+            if(policy_ == PoolExhaustion::REJECT) return nullptr;
+            AddSlab();
+        }
+
+        auto* slot{free_};
+        auto* next{slot->next_};
+        auto* object{new (slot->storage_) T(std::forward<Args>(args)...)};
+        free_ = next;
+        ++in_use_;
+        return object;
+    }
+    /// @brief Destroy an object and return it to the pool
+    /// @param object An object previously acquired from this pool
+    void Release(T* object) {
+        auto* slot{reinterpret_cast<Slot*>(object)};
+        object->~T();
+        slot->next_ = free_;
+        free_ = slot;
+        --in_use_;
+    }
+    /// @brief Returns the number of objects the pool currently holds
+    std::size_t Capacity() const { return slabs_.size() * slab_size_; }
+    /// @brief Returns the number of objects currently acquired
+    std::size_t InUse() const { return in_use_; }
+
+private:
+    union Slot {
+        T* Object() { return std::launder(reinterpret_cast<T*>(storage_)); }
+
+        Slot* next_;
+        alignas(T) std::byte storage_[sizeof(T)];
+    };
+
+    void AddSlab() {
+        auto& slab{slabs_.emplace_back(std::make_unique<Slot[]>(slab_size_))};
+        for(std::size_t index = slab_size_; index-- != 0;) {
+            slab[index].next_ = free_;
+            free_ = &slab[index];
+        }
+    }
+
+    std::size_t const slab_size_;
+    PoolExhaustion const policy_;
+    std::vector<std::unique_ptr<Slot[]>> slabs_{};
+    Slot* free_{};
+    std::size_t in_use_{};
+};
+}
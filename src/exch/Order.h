@@ -18,22 +18,25 @@
 /// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 /// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 /// SOFTWARE.
+#include    <common/TscClock.h>
+
 #include    <chrono>
 #include    <cstddef>
+#include    <cstdint>
 #include    <string>
 
 namespace pentifica::trd::exch {
 /// @brief Identifies the type of the order
 enum class OrderSide:char {BUY = 'B', SELL = 'S', UNKNOWN = 'U'};
-enum class OrderType:char {MARKET = 'M', LIMIT = 'L', UNKNOWN = 'U'};
-enum class OrderTimeInForce:char {IOC = 'I', DAY = 'D', GTC = 'G', UNKNOWN = 'U'};
+enum class OrderType:char {MARKET = 'M', LIMIT = 'L', STOP = 'S', STOP_LIMIT = 'T', UNKNOWN = 'U'};
+enum class OrderTimeInForce:char {IOC = 'I', FOK = 'F', DAY = 'D', GTC = 'G', GTD = 'T', UNKNOWN = 'U'};
 /// @brief  Defines the minimum information to describe a generic order
 /// @tparam T   Specifies the data type of the price associated with the order.
 template<typename T>
 class Order {
 public:
     using PriceType = T;
-    using Clock = std::chrono::high_resolution_clock;
+    using Clock = TscClock;
     using TimePoint = Clock::time_point;
 
     Order() = default;
@@ -58,25 +61,51 @@ public:
     Order& operator=(Order&&) = default;
 
     void Price(T price) { price_ = price; }
+    void StopPrice(T price) { stop_price_ = price; }
     void Quantity(size_t quantity) { quantity_ = quantity; }
+    void MaxShow(size_t max_show) { max_show_ = max_show; }
+    void MinQty(size_t min_qty) { min_qty_ = min_qty; }
     void Time(TimePoint time) { time_ = time; }
+    void ExpireTime(TimePoint time) { expire_time_ = time; }
     void Side(OrderSide side) { side_ = side; }
     void Type(OrderType type) { type_ = type; }
     void TIF(OrderTimeInForce tif) { tif_ = tif; }
+    void Key(std::uint64_t key) { key_ = key; }
+    void Account(std::string account) { account_ = std::move(account); }
+    void Session(std::string session) { session_ = std::move(session); }
 
     auto const& Id() const { return id_; }
     auto Price() const { return price_; }
+    auto StopPrice() const { return stop_price_; }
     auto Quantity() const { return quantity_; }
+    auto MaxShow() const { return max_show_; }
+    auto MinQty() const { return min_qty_; }
     auto Time() const { return time_; }
+    auto ExpireTime() const { return expire_time_; }
     auto Side() const { return side_; }
     auto Type() const { return type_; }
     auto TIF() const { return tif_; }
+    auto Key() const { return key_; }
+    auto const& Account() const { return account_; }
+    auto const& Session() const { return session_; }
 
 private:
     T price_{};
+    T stop_price_{};
     std::size_t quantity_{};
+    /// @brief The most quantity displayed at a time; 0 displays all of it
+    std::size_t max_show_{};
+    /// @brief The least quantity that must execute on arrival; 0 for any
+    std::size_t min_qty_{};
     TimePoint time_{};
+    /// @brief When a good till date order leaves the book
+    TimePoint expire_time_{};
     std::string id_;
+    std::uint64_t key_{};
+    /// @brief The account the order is for; empty if none
+    std::string account_;
+    /// @brief The session, by SenderCompID, the order arrived on; empty if none
+    std::string session_;
     OrderSide side_{OrderSide::UNKNOWN};
     OrderType type_{OrderType::UNKNOWN};
     OrderTimeInForce tif_{OrderTimeInForce::UNKNOWN};
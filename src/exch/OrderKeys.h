@@ -0,0 +1,108 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <FlatHashMap.h>
+#include    <FixedId.h>
+
+#include    <cstddef>
+#include    <cstdint>
+#include    <string>
+#include    <unordered_map>
+#include    <utility>
+
+namespace pentifica::trd::exch {
+/// @brief  std::unordered_map presented through the interface the engine
+///         expects of its order book
+/// @tparam Key     The key type
+/// @tparam Value   The value type
+template<typename Key, typename Value>
+class NodeHashMap {
+public:
+    explicit NodeHashMap(std::size_t reserve = 0) { map_.reserve(reserve); }
+
+    Value* Find(Key const& key) {
+        auto index{map_.find(key)};
+        return (index == map_.end()) ? nullptr : &index->second;
+    }
+    std::pair<Value*, bool> TryEmplace(Key const& key) {
+        auto [index, added] = map_.try_emplace(key);
+        return {&index->second, added};
+    }
+    void Erase(Key const& key) { map_.erase(key); }
+    std::size_t Size() const { return map_.size(); }
+    template<typename Visit>
+    void ForEach(Visit&& visit) {
+        for(auto& [key, value] : map_) visit(key, value);
+    }
+
+private:
+    std::unordered_map<Key, Value> map_{};
+};
+/// @brief Orders are keyed by their string identifier
+struct IdKeys {
+    using KeyType = std::string;
+    static constexpr std::size_t reserve{0};
+
+    template<typename OrderDef>
+    static KeyType const& Key(OrderDef const& order) { return order.Id(); }
+    /// @brief Indicates an order's identifier can key it
+    template<typename OrderDef>
+    static bool Fits(OrderDef const&) { return true; }
+
+    template<typename Value>
+    using Book = NodeHashMap<KeyType, Value>;
+};
+/// @brief  Orders are keyed by their identifier held inline, at most a
+///         ClOrdID wide, in a flat table: neither a lookup nor an insert
+///         allocates
+/// @tparam Reserve The number of resting orders provisioned for up front
+template<std::size_t Reserve = 1024>
+struct FixedIdKeys {
+    using KeyType = FixedId<order_id_width>;
+    static constexpr std::size_t reserve{Reserve};
+
+    /// @throw std::length_error if the order's identifier is too long
+    template<typename OrderDef>
+    static KeyType Key(OrderDef const& order) { return KeyType(order.Id()); }
+    /// @brief Indicates an order's identifier is no wider than a ClOrdID
+    template<typename OrderDef>
+    static bool Fits(OrderDef const& order) { return order.Id().size() <= order_id_width; }
+
+    template<typename Value>
+    using Book = FlatHashMap<KeyType, Value, IdHash>;
+};
+/// @brief  Orders are keyed by a 64 bit key, typically interned from the
+///         ClOrdID at the gateway, held in a flat table
+/// @tparam Reserve The number of resting orders provisioned for up front
+template<std::size_t Reserve = 1024>
+struct IntegerKeys {
+    using KeyType = std::uint64_t;
+    static constexpr std::size_t reserve{Reserve};
+
+    template<typename OrderDef>
+    static KeyType Key(OrderDef const& order) { return order.Key(); }
+    /// @brief Indicates an order's identifier can key it
+    template<typename OrderDef>
+    static bool Fits(OrderDef const&) { return true; }
+
+    template<typename Value>
+    using Book = FlatHashMap<KeyType, Value>;
+};
+}
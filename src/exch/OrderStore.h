@@ -0,0 +1,74 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <ObjectPool.h>
+
+#include    <cstddef>
+#include    <memory>
+#include    <type_traits>
+
+namespace pentifica::trd::exch {
+/// @brief  Orders are shared with the caller through std::shared_ptr. The
+///         caller may keep observing an order after handing it to the engine.
+struct SharedOrders {
+    template<typename OrderDef>
+    class Store {
+    public:
+        using OrderRef = std::shared_ptr<OrderDef>;
+        /// @brief Take a copy of an order into the store
+        OrderRef Admit(OrderDef const& order) { return std::make_shared<OrderDef>(order); }
+        /// @brief Provide the revised version of an order held by the store
+        OrderRef Replace(OrderRef const&, OrderDef const& revised) { return Admit(revised); }
+        /// @brief The engine no longer references the order
+        void Release(OrderRef const&) {}
+    };
+};
+/// @brief  Orders are copied into a preallocated pool owned by the engine and
+///         referenced through plain pointers. An order's handle is valid for
+///         as long as the order rests in the book; handles of orders that do
+///         not rest are only valid while the callback they appear in runs.
+///         Only orders that own no heap storage, such as @ref CompactOrder,
+///         can be pooled, so taking an order in never allocates.
+/// @tparam Capacity The number of orders preallocated
+/// @tparam Policy What to do once Capacity orders are live
+template<std::size_t Capacity, PoolExhaustion Policy = PoolExhaustion::REJECT>
+struct PooledOrders {
+    template<typename OrderDef>
+    class Store {
+        static_assert(std::is_trivially_copyable_v<OrderDef>,
+            "Pooled orders must be trivially copyable, owning no heap storage");
+    public:
+        using OrderRef = OrderDef*;
+        /// @brief Take a copy of an order into the store
+        /// @return The stored order or nullptr if the pool is exhausted
+        OrderRef Admit(OrderDef const& order) { return pool_.Acquire(order); }
+        /// @brief Revise an order held by the store in place
+        OrderRef Replace(OrderRef original, OrderDef const& revised) {
+            *original = revised;
+            return original;
+        }
+        /// @brief Return an order to the pool
+        void Release(OrderRef order) { pool_.Release(order); }
+
+    private:
+        ObjectPool<OrderDef> pool_{Capacity, Policy};
+    };
+};
+}
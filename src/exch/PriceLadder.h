@@ -0,0 +1,285 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <common/TickPrice.h>
+
+#include    <map>
+#include    <vector>
+#include    <array>
+#include    <bit>
+#include    <cstddef>
+#include    <cstdint>
+#include    <iterator>
+#include    <stdexcept>
+#include    <type_traits>
+#include    <utility>
+
+namespace pentifica::trd::exch {
+/// @brief  A price ladder backed by an ordered map. Suitable for instruments
+///         whose prices are not bounded to a known range. Erased levels keep
+///         their map nodes on a free list, reset, for reuse by the next level
+///         created, so a book that churns through prices stops allocating
+///         once it has reached its working depth.
+/// @tparam PriceType   The price type
+/// @tparam Level       The per-price level type
+/// @tparam Compare     Orders prices from best to worst
+template<typename PriceType, typename Level, typename Compare>
+class MapLadder {
+public:
+    using Levels = std::map<PriceType, Level, Compare>;
+    using Node = Levels::node_type;
+    using CompareType = Compare;
+    using iterator = Levels::iterator;
+    using const_iterator = Levels::const_iterator;
+
+    bool Empty() const { return levels_.empty(); }
+    std::size_t Size() const { return levels_.size(); }
+    /// @brief Returns the price of the best level. The ladder must not be empty.
+    PriceType BestPrice() const { return levels_.begin()->first; }
+    /// @brief Returns the price of the worst level. The ladder must not be empty.
+    PriceType WorstPrice() const { return levels_.rbegin()->first; }
+    /// @brief Returns the best level. The ladder must not be empty.
+    Level& Best() { return levels_.begin()->second; }
+    Level const& Best() const { return levels_.begin()->second; }
+    /// @brief Locate the level at a price
+    /// @param price The price of the level
+    /// @return The level or nullptr if there is no level at that price
+    Level* Find(PriceType price) {
+        auto index{levels_.find(price)};
+        return (index == levels_.end()) ? nullptr : &index->second;
+    }
+    /// @brief Locate the level at a price, creating it if needed
+    /// @param price The price of the level
+    /// @return The level
+    Level& operator[](PriceType price) {
+        auto index{levels_.lower_bound(price)};
+        if(index != levels_.end() && !Compare{}(price, index->first)) return index->second;
+        if(spare_.empty()) return levels_.try_emplace(index, price)->second;
+
+        auto node{std::move(spare_.back())};
+        spare_.pop_back();
+        node.key() = price;
+        return levels_.insert(index, std::move(node))->second;
+    }
+    /// @brief Indicates if a level may be created at a price
+    bool Accepts(PriceType) const { return true; }
+    /// @brief Remove the level at a price, keeping its storage for reuse
+    /// @param price The price of the level
+    void Erase(PriceType price) {
+        auto index{levels_.find(price)};
+        if(index == levels_.end()) return;
+        auto node{levels_.extract(index)};
+        node.mapped() = Level{};
+        spare_.push_back(std::move(node));
+    }
+    /// @brief Returns the number of erased levels held for reuse
+    std::size_t Spare() const { return spare_.size(); }
+
+    iterator begin() { return levels_.begin(); }
+    iterator end() { return levels_.end(); }
+    const_iterator begin() const { return levels_.begin(); }
+    const_iterator end() const { return levels_.end(); }
+
+private:
+    Levels levels_{};
+    std::vector<Node> spare_{};
+};
+/// @brief  A price ladder backed by a contiguous array of levels indexed by
+///         tick. Live levels may lie anywhere as long as the best and worst
+///         of them are less than Depth ticks apart; the window slides with
+///         the market without moving any level. A bitmap of occupied levels
+///         locates the next non-empty level.
+/// @tparam PriceType   The price type. Must be an integral tick count or a
+///                     TickPrice.
+/// @tparam Level       The per-price level type
+/// @tparam Compare     Orders prices from best to worst
+/// @tparam Depth       The number of ticks the ladder spans. Power of 2.
+template<typename PriceType, typename Level, typename Compare, std::size_t Depth>
+class TickLadder {
+    static_assert(std::is_integral_v<PriceType> || is_tick_price_v<PriceType>,
+        "TickLadder requires tick count prices");
+    static_assert(std::has_single_bit(Depth) && Depth >= 64, "Depth must be a power of 2 >= 64");
+public:
+    using CompareType = Compare;
+    /// @brief Iterates the occupied levels from best to worst
+    template<typename LadderType, typename LevelType>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<PriceType, LevelType&>;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        Iterator(LadderType* ladder, PriceType price) :
+            ladder_{ladder}, price_{price} {}
+
+        value_type operator*() const { return {price_, ladder_->levels_[Slot(price_)]}; }
+        Iterator& operator++() {
+            if(price_ == ladder_->worst_)   ladder_ = nullptr;
+            else                            price_ = ladder_->Next(price_);
+            return *this;
+        }
+        Iterator operator++(int) { auto save{*this}; ++*this; return save; }
+        bool operator==(Iterator const& other) const {
+            return ladder_ == other.ladder_ && (!ladder_ || price_ == other.price_);
+        }
+
+    private:
+        LadderType* ladder_{};
+        PriceType price_{};
+    };
+    using iterator = Iterator<TickLadder, Level>;
+    using const_iterator = Iterator<TickLadder const, Level const>;
+
+    TickLadder() : levels_(Depth) {}
+
+    bool Empty() const { return size_ == 0; }
+    std::size_t Size() const { return size_; }
+    PriceType BestPrice() const { return best_; }
+    PriceType WorstPrice() const { return worst_; }
+    Level& Best() { return levels_[Slot(best_)]; }
+    Level const& Best() const { return levels_[Slot(best_)]; }
+    /// @brief Locate the level at a price
+    /// @param price The price of the level
+    /// @return The level or nullptr if there is no level at that price
+    Level* Find(PriceType price) {
+        if(!Covers(price) || !Occupied(Slot(price))) return nullptr;
+        return &levels_[Slot(price)];
+    }
+    /// @brief Locate the level at a price, creating it if needed
+    /// @param price The price of the level
+    /// @return The level
+    /// @throw std::out_of_range if the ladder would span Depth or more ticks
+    Level& operator[](PriceType price) {
+        auto const slot{Slot(price)};
+        if(Empty()) {
+            best_ = worst_ = price;
+        }
+        else if(!Covers(price)) {
+            auto const best{Compare{}(price, best_) ? price : best_};
+            auto const worst{Compare{}(worst_, price) ? price : worst_};
+            if(Span(best, worst) >= Depth) {
+                throw std::out_of_range("Price outside tick ladder range");
+            }
+            best_ = best;
+            worst_ = worst;
+        }
+        else if(Occupied(slot)) {
+            return levels_[slot];
+        }
+
+        occupied_[slot / bits] |= std::uint64_t{1} << (slot % bits);
+        ++size_;
+        return levels_[slot];
+    }
+    /// @brief Indicates if a level may be created at a price
+    bool Accepts(PriceType price) const {
+        if(Empty() || Covers(price)) return true;
+        return Compare{}(price, best_) ? Span(price, worst_) < Depth
+                                       : Span(best_, price) < Depth;
+    }
+    /// @brief Mark the level at a price as no longer in use. The level object
+    ///        itself is retained for reuse.
+    /// @param price The price of the level
+    void Erase(PriceType price) {
+        auto const slot{Slot(price)};
+        if(!Covers(price) || !Occupied(slot)) return;
+
+        occupied_[slot / bits] &= ~(std::uint64_t{1} << (slot % bits));
+        if(--size_ == 0) return;
+
+        if(price == best_)          best_ = Next(price);
+        else if(price == worst_)    worst_ = Prev(price);
+    }
+
+    iterator begin() { return Empty() ? end() : iterator{this, best_}; }
+    iterator end() { return iterator{}; }
+    const_iterator begin() const { return Empty() ? end() : const_iterator{this, best_}; }
+    const_iterator end() const { return const_iterator{}; }
+
+private:
+    static constexpr std::size_t bits{64};
+    static constexpr std::size_t mask{Depth - 1};
+    static constexpr bool ascending{Compare{}(PriceType{0}, PriceType{1})};
+
+    static std::size_t Slot(PriceType price) { return static_cast<std::size_t>(TicksOf(price)) & mask; }
+    bool Occupied(std::size_t slot) const {
+        return (occupied_[slot / bits] >> (slot % bits)) & 1;
+    }
+    static std::size_t Span(PriceType best, PriceType worst) {
+        return ascending ? static_cast<std::size_t>(TicksOf(worst - best))
+                         : static_cast<std::size_t>(TicksOf(best - worst));
+    }
+    /// @brief Indicates if a price lies between the best and worst prices
+    bool Covers(PriceType price) const {
+        return !Empty() && !Compare{}(price, best_) && !Compare{}(worst_, price);
+    }
+    /// @brief Returns the next occupied price after price, towards worst
+    PriceType Next(PriceType price) const {
+        return ascending ? price + 1 + static_cast<PriceType>(ScanUp(Slot(price + 1)))
+                         : price - 1 - static_cast<PriceType>(ScanDown(Slot(price - 1)));
+    }
+    /// @brief Returns the next occupied price before price, towards best
+    PriceType Prev(PriceType price) const {
+        return ascending ? price - 1 - static_cast<PriceType>(ScanDown(Slot(price - 1)))
+                         : price + 1 + static_cast<PriceType>(ScanUp(Slot(price + 1)));
+    }
+    /// @brief Returns the distance from slot to the nearest occupied slot at or above it
+    std::size_t ScanUp(std::size_t slot) const {
+        for(std::size_t distance = 0; distance < Depth;) {
+            auto const bit{slot % bits};
+            auto const word{occupied_[slot / bits] >> bit};
+            if(word) return distance + static_cast<std::size_t>(std::countr_zero(word));
+            distance += bits - bit;
+            slot = (slot + bits - bit) & mask;
+        }
+        return Depth;
+    }
+    /// @brief Returns the distance from slot to the nearest occupied slot at or below it
+    std::size_t ScanDown(std::size_t slot) const {
+        for(std::size_t distance = 0; distance < Depth;) {
+            auto const bit{slot % bits};
+            auto const word{occupied_[slot / bits] << (bits - 1 - bit)};
+            if(word) return distance + static_cast<std::size_t>(std::countl_zero(word));
+            distance += bit + 1;
+            slot = (slot - bit - 1) & mask;
+        }
+        return Depth;
+    }
+
+    std::vector<Level> levels_;
+    std::array<std::uint64_t, Depth / bits> occupied_{};
+    PriceType best_{};
+    PriceType worst_{};
+    std::size_t size_{};
+};
+/// @brief Selects @ref MapLadder for both sides of a book
+struct MapLadders {
+    template<typename PriceType, typename Level, typename Compare>
+    using Ladder = MapLadder<PriceType, Level, Compare>;
+};
+/// @brief  Selects @ref TickLadder for both sides of a book
+/// @tparam Depth The number of ticks each side spans
+template<std::size_t Depth>
+struct TickLadders {
+    template<typename PriceType, typename Level, typename Compare>
+    using Ladder = TickLadder<PriceType, Level, Compare, Depth>;
+};
+}
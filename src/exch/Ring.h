@@ -0,0 +1,196 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <algorithm>
+#include    <atomic>
+#include    <bit>
+#include    <cstddef>
+#include    <cstdint>
+#include    <memory>
+#include    <stdexcept>
+#include    <utility>
+
+namespace pentifica::trd::exch {
+/// @brief Size of a cache line, used to keep independently written fields apart
+inline constexpr std::size_t cache_line_size{64};
+/// @brief  A bounded lock-free queue for exactly one producer thread and one
+///         consumer thread. The producer and consumer indexes live on their
+///         own cache lines and each side caches the other's index so that
+///         the shared lines are only read when the cached view runs out.
+/// @tparam T The element type. Must be default constructible and movable.
+template<typename T>
+class SpscRing {
+public:
+    /// @brief Prepare a ring
+    /// @param capacity The minimum number of elements the ring holds. It is
+    ///        rounded up to a power of 2.
+    explicit SpscRing(std::size_t capacity) :
+        capacity_{std::bit_ceil(capacity)},
+        mask_{capacity_ - 1},
+        slots_{std::make_unique<T[]>(capacity_)}
+    {
+        if(capacity == 0) throw std::invalid_argument("capacity == 0");
+    }
+    SpscRing(SpscRing const&) = delete;
+    SpscRing& operator=(SpscRing const&) = delete;
+
+    std::size_t Capacity() const { return capacity_; }
+    /// @brief Producer: append an element
+    /// @return false if the ring is full
+    template<typename U>
+    bool TryPush(U&& value) {
+        auto const tail{producer_.index_.load(std::memory_order_relaxed)};
+        if(tail - producer_.cached_ == capacity_) {
+            producer_.cached_ = consumer_.index_.load(std::memory_order_acquire);
+            if(tail - producer_.cached_ == capacity_) return false;
+        }
+        slots_[tail & mask_] = std::forward<U>(value);
+        producer_.index_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    /// @brief Consumer: remove the oldest element
+    /// @return false if the ring is empty
+    bool TryPop(T& value) {
+        return Drain([&value](T& item) { value = std::move(item); }, 1) == 1;
+    }
+    /// @brief Consumer: remove up to limit elements, oldest first
+    /// @param visit Invoked with each element removed
+    /// @param limit The maximum number of elements to remove
+    /// @return The number of elements removed
+    template<typename Visit>
+    std::size_t Drain(Visit&& visit, std::size_t limit) {
+        auto const head{consumer_.index_.load(std::memory_order_relaxed)};
+        if(consumer_.cached_ == head) {
+            consumer_.cached_ = producer_.index_.load(std::memory_order_acquire);
+            if(consumer_.cached_ == head) return 0;
+        }
+        auto const count{std::min(limit, consumer_.cached_ - head)};
+        for(std::size_t index = 0; index < count; ++index) {
+            visit(slots_[(head + index) & mask_]);
+        }
+        consumer_.index_.store(head + count, std::memory_order_release);
+        return count;
+    }
+    /// @brief Returns an estimate of the number of elements queued
+    std::size_t Size() const {
+        return producer_.index_.load(std::memory_order_acquire)
+            - consumer_.index_.load(std::memory_order_acquire);
+    }
+
+private:
+    /// @brief One side's index and its cached view of the other side's index
+    struct alignas(cache_line_size) Side {
+        std::atomic<std::size_t> index_{};
+        std::size_t cached_{};
+    };
+
+    std::size_t const capacity_;
+    std::size_t const mask_;
+    std::unique_ptr<T[]> slots_;
+    Side producer_{};
+    Side consumer_{};
+};
+/// @brief  A bounded lock-free queue for any number of producer threads and
+///         one consumer thread. Each cell carries a sequence number telling
+///         producers and the consumer whose turn it is, and sits on its own
+///         cache line so that neighbouring producers do not contend.
+/// @tparam T The element type. Must be default constructible and movable.
+template<typename T>
+class MpscRing {
+public:
+    /// @brief Prepare a ring
+    /// @param capacity The minimum number of elements the ring holds. It is
+    ///        rounded up to a power of 2.
+    explicit MpscRing(std::size_t capacity) :
+        capacity_{std::bit_ceil(capacity)},
+        mask_{capacity_ - 1},
+        cells_{std::make_unique<Cell[]>(capacity_)}
+    {
+        if(capacity == 0) throw std::invalid_argument("capacity == 0");
+        for(std::size_t index = 0; index < capacity_; ++index) {
+            cells_[index].sequence_.store(index, std::memory_order_relaxed);
+        }
+    }
+    MpscRing(MpscRing const&) = delete;
+    MpscRing& operator=(MpscRing const&) = delete;
+
+    std::size_t Capacity() const { return capacity_; }
+    /// @brief Producer: append an element
+    /// @return false if the ring is full
+    template<typename U>
+    bool TryPush(U&& value) {
+        auto tail{tail_.load(std::memory_order_relaxed)};
+        for(;;) {
+            auto& cell{cells_[tail & mask_]};
+            auto const sequence{cell.sequence_.load(std::memory_order_acquire)};
+            auto const lag{static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(tail)};
+            if(lag == 0) {
+                if(tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    cell.value_ = std::forward<U>(value);
+                    cell.sequence_.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(lag < 0) {
+                return false;
+            }
+            else {
+                tail = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    /// @brief Consumer: remove the oldest element
+    /// @return false if the ring is empty
+    bool TryPop(T& value) {
+        return Drain([&value](T& item) { value = std::move(item); }, 1) == 1;
+    }
+    /// @brief Consumer: remove up to limit elements, oldest first. Stops
+    ///        early at an element a producer has claimed but not yet written.
+    /// @param visit Invoked with each element removed
+    /// @param limit The maximum number of elements to remove
+    /// @return The number of elements removed
+    template<typename Visit>
+    std::size_t Drain(Visit&& visit, std::size_t limit) {
+        std::size_t count{};
+        for(; count < limit; ++count, ++head_.index_) {
+            auto& cell{cells_[head_.index_ & mask_]};
+            if(cell.sequence_.load(std::memory_order_acquire) != head_.index_ + 1) break;
+            visit(cell.value_);
+            cell.sequence_.store(head_.index_ + capacity_, std::memory_order_release);
+        }
+        return count;
+    }
+
+private:
+    struct alignas(cache_line_size) Cell {
+        std::atomic<std::size_t> sequence_{};
+        T value_{};
+    };
+    struct alignas(cache_line_size) Head {
+        std::size_t index_{};
+    };
+
+    std::size_t const capacity_;
+    std::size_t const mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(cache_line_size) std::atomic<std::size_t> tail_{};
+    Head head_{};
+};
+}
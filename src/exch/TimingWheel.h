@@ -0,0 +1,201 @@
+#pragma once
+/// @copyright {2023, Russell J. Fleming. All rights reserved.}
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+/// SOFTWARE.
+#include    <IntrusiveList.h>
+
+#include    <array>
+#include    <bit>
+#include    <cstddef>
+#include    <cstdint>
+
+namespace pentifica::trd::exch {
+/// @brief  Links embedded in an element of a @ref TimingWheel along with the
+///         tick the element is due at and the slot holding it. Four words.
+/// @tparam T The element type
+template<typename T>
+struct WheelLink : IntrusiveLink<T, WheelLink<T>> {
+    std::uint64_t deadline_{};
+    IntrusiveList<T, WheelLink<T>>* slot_{};
+};
+/// @brief  A hierarchical timing wheel. Level 0 holds the elements due within
+///         the next Slots ticks, one slot per tick; each further level covers
+///         Slots times the span of the one below with the same number of
+///         slots. As time reaches a slot of an upper level its elements are
+///         redistributed to the levels below, so an element moves at most
+///         Levels times before it is due: scheduling, cancelling and expiring
+///         are O(1) amortized. Elements due beyond the span of the top level
+///         wait on an overflow list that is only examined when time enters a
+///         new top level span. Stretches of time with nothing due at the
+///         lower levels are skipped, not stepped through tick by tick.
+/// @tparam T           The element type, derived from WheelLink<T>
+/// @tparam Levels      The number of levels
+/// @tparam SlotBits    The log 2 of the number of slots per level
+template<typename T, std::size_t Levels = 4, std::size_t SlotBits = 8>
+class TimingWheel {
+    static_assert(Levels > 0 && Levels * SlotBits < 64, "Wheel span must fit in 64 bits");
+public:
+    using Link = WheelLink<T>;
+    using Slot = IntrusiveList<T, Link>;
+
+    TimingWheel() = default;
+    TimingWheel(TimingWheel const&) = delete;
+    TimingWheel(TimingWheel&&) = delete;
+    ~TimingWheel() = default;
+    TimingWheel& operator=(TimingWheel const&) = delete;
+    TimingWheel& operator=(TimingWheel&&) = delete;
+    /// @brief Schedule an element
+    /// @param item The element. It must not be scheduled.
+    /// @param deadline The tick the element is due at. An element whose
+    ///        deadline has passed is due at the next advance.
+    void Schedule(T& item, std::uint64_t deadline) {
+        Links(item).deadline_ = deadline;
+        Place(item);
+        ++size_;
+    }
+    /// @brief Remove an element from the wheel. Does nothing if the element
+    ///        is not scheduled.
+    void Cancel(T& item) {
+        auto& links{Links(item)};
+        if(!links.slot_) return;
+        Unhook(item);
+        --size_;
+    }
+    /// @brief  Move time forward, expiring every element due at or before
+    ///         the new time, earliest tick first. An element is removed from
+    ///         the wheel before it is expired.
+    /// @param now The new time. Time never moves backwards.
+    /// @param expire Invoked with each element due
+    /// @return The number of elements expired
+    template<typename Expire>
+    std::size_t Advance(std::uint64_t now, Expire&& expire) {
+        auto count{ExpireAll(due_, expire)};
+        while(now_ < now) {
+            std::size_t level{};
+            while(level < Levels && counts_[level] == 0) ++level;
+            if(level == Levels) {
+                MoveTo(now);
+                break;
+            }
+            //  nothing lies below level, so skip to its next slot boundary
+            auto const last{now_ | (Span(level) - 1)};
+            if(last >= now) {
+                now_ = now;
+                break;
+            }
+            MoveTo(last + 1);
+            for(auto cascade{Boundary()}; cascade > 0; --cascade) {
+                Redistribute(At(cascade, now_));
+            }
+            count += ExpireAll(At(0, now_), expire);
+        }
+        return count + ExpireAll(due_, expire);
+    }
+    /// @brief Returns the number of scheduled elements
+    std::size_t Size() const { return size_; }
+    /// @brief Returns the current tick
+    std::uint64_t Now() const { return now_; }
+
+private:
+    static constexpr std::size_t slots{std::size_t{1} << SlotBits};
+    static constexpr std::uint64_t mask{slots - 1};
+
+    static Link& Links(T& item) { return static_cast<Link&>(item); }
+    static std::uint64_t Span(std::size_t level) { return std::uint64_t{1} << (SlotBits * level); }
+    static std::size_t Index(std::uint64_t tick, std::size_t level) {
+        return static_cast<std::size_t>((tick >> (SlotBits * level)) & mask);
+    }
+    /// @brief Returns the slot of a level a tick falls in
+    Slot& At(std::size_t level, std::uint64_t tick) { return wheel_[level * slots + Index(tick, level)]; }
+    /// @brief Returns the level a slot belongs to; Levels for the overflow
+    ///        and due lists
+    std::size_t LevelOf(Slot const* slot) const {
+        if(slot == &overflow_ || slot == &due_) return Levels;
+        return static_cast<std::size_t>(slot - wheel_.data()) / slots;
+    }
+    /// @brief Returns the highest level whose slot boundary the current tick is on
+    std::size_t Boundary() const {
+        if(now_ == 0) return 0;
+        auto const level{static_cast<std::size_t>(std::countr_zero(now_)) / SlotBits};
+        return level < Levels ? level : Levels - 1;
+    }
+    /// @brief Put an element in the slot its deadline falls in
+    void Place(T& item) {
+        auto& links{Links(item)};
+        if(links.deadline_ <= now_) {
+            Hook(item, due_);
+            return;
+        }
+        auto const level{static_cast<std::size_t>(std::bit_width(links.deadline_ ^ now_) - 1) / SlotBits};
+        if(level >= Levels) {
+            Hook(item, overflow_);
+            return;
+        }
+        Hook(item, At(level, links.deadline_));
+        ++counts_[level];
+    }
+    void Hook(T& item, Slot& slot) {
+        Links(item).slot_ = &slot;
+        slot.PushBack(item);
+    }
+    void Unhook(T& item) {
+        auto& links{Links(item)};
+        links.slot_->Erase(item);
+        if(auto const level{LevelOf(links.slot_)}; level < Levels) --counts_[level];
+        links.slot_ = nullptr;
+    }
+    /// @brief Set the current tick, bringing overflow elements into the
+    ///        wheel when the tick enters a new top level span
+    void MoveTo(std::uint64_t tick) {
+        auto const top{SlotBits * Levels};
+        auto const crossed{(tick >> top) != (now_ >> top)};
+        now_ = tick;
+        if(crossed) Redistribute(overflow_);
+    }
+    /// @brief Place the elements of a slot again relative to the current tick
+    void Redistribute(Slot& slot) {
+        for(auto pending{slot.Size()}; pending; --pending) {
+            auto& item{slot.Front()};
+            Unhook(item);
+            Place(item);
+        }
+    }
+    /// @brief Expire every element of a slot
+    template<typename Expire>
+    std::size_t ExpireAll(Slot& slot, Expire& expire) {
+        std::size_t count{};
+        while(!slot.Empty()) {
+            auto& item{slot.Front()};
+            Unhook(item);
+            --size_;
+            ++count;
+            expire(item);
+        }
+        return count;
+    }
+
+    /// @brief The slots of every level, level 0 first
+    std::array<Slot, Levels * slots> wheel_{};
+    std::array<std::size_t, Levels> counts_{};
+    Slot overflow_{};
+    Slot due_{};
+    std::uint64_t now_{};
+    std::size_t size_{};
+};
+}
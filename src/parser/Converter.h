@@ -18,6 +18,8 @@
 /// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 /// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 /// SOFTWARE.
+#include    <common/TickPrice.h>
+
 #include    <string>
 #include    <string_view>
 #include    <numeric>
@@ -69,6 +71,32 @@ namespace pentifica::trd {
 
         return sign * result;
     }
+    /// @brief  Converts a string containing a decimal value to a fixed point
+    ///         price without going through floating point. Digits beyond the
+    ///         price's precision are dropped.
+    /// @tparam T   The @ref TickPrice type
+    /// @param view A view of the decimal value string
+    /// @return The price
+    template<typename T>
+    T tick_converter(std::string_view const& view) {
+        using Rep = T::RepType;
+        auto begin = view.begin();
+
+        bool const negative{begin != view.end() && *begin == '-'};
+        if(negative) ++begin;
+
+        auto decimal = std::find(begin, view.end(), '.');
+        Rep ticks{numeric_converter<Rep>(std::string_view(begin, decimal)) * T::scale};
+
+        if(decimal != view.end()) {
+            Rep place{T::scale};
+            for(auto digit = decimal + 1; digit != view.end() && (place /= 10) != 0; ++digit) {
+                ticks += (*digit - '0') * place;
+            }
+        }
+
+        return T{negative ? -ticks : ticks};
+    }
     /// @brief Workaround to allow static_assert to fail
     /// @tparam T   Placeholder
     template<typename T> struct Unsupported : std::false_type {};
@@ -116,6 +144,11 @@ namespace pentifica::trd {
             return real_converter<T>(view);
         }
 
+        //  fixed point prices
+        else if constexpr(is_tick_price_v<T>) {
+            return tick_converter<T>(view);
+        }
+
         //  unhandled
         else {
             static_assert(Unsupported<T>::value, "Unsupported type");
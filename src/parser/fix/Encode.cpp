@@ -19,8 +19,10 @@
 /// SOFTWARE.
 #include    "Encode.h"
 #include    "Utility.h"
+#include    <common/TscClock.h>
 
 #include    <stdexcept>
+#include    <chrono>
 #include    <cmath>
 #include    <ctime>
 #include    <string>
@@ -50,8 +52,12 @@ namespace pentifica::trd::fix {
     
         //  timestamp the message completion
         auto save_next = next_;
+        auto const since_epoch{TscClock::now().time_since_epoch()};
+        auto const seconds{std::chrono::duration_cast<std::chrono::seconds>(since_epoch)};
         struct timeval tv;
-        gettimeofday(&tv, 0);
+        tv.tv_sec = static_cast<time_t>(seconds.count());
+        tv.tv_usec = static_cast<suseconds_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(since_epoch - seconds).count());
         next_ = sending_time_field_;
         Append(tv);
         next_ = save_next;
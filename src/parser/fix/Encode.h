@@ -19,6 +19,7 @@
 /// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 /// SOFTWARE.
 #include    "Tags.h"
+#include    <common/TickPrice.h>
 
 #include    <cstdint>
 #include    <cstdlib>
@@ -131,6 +132,27 @@ namespace pentifica::trd::fix {
         void Append(struct tm tm);
         void Append(struct timeval value);
         void Append(double value, double digits = 6.0);
+        /// @brief Update the message contents with a fixed point price,
+        ///        written with all of its decimal places
+        template<unsigned Decimals, typename Rep>
+        void Append(TickPrice<Decimals, Rep> value) {
+            auto ticks{static_cast<uint64_t>(value.Ticks())};
+            if(value.Ticks() < 0) {
+                Append('-');
+                ticks = ~ticks + 1;
+            }
+            AppendUnsigned(ticks / static_cast<uint64_t>(value.scale));
+            if constexpr(Decimals != 0) {
+                Append('.');
+                auto fraction{ticks % static_cast<uint64_t>(value.scale)};
+                auto const begin{next_};
+                for(auto digit = Decimals; digit != 0; --digit) {
+                    AppendByte(static_cast<Byte>(fraction % 10) + '0');
+                    fraction /= 10;
+                }
+                std::reverse(begin, next_);
+            }
+        }
         /// @brief Update the message contents with the unsigned value
         /// @tparam T The value type
         /// @param value The value to format
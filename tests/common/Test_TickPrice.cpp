@@ -0,0 +1,43 @@
+#include    <common/TickPrice.h>
+
+#include    <gtest/gtest.h>
+
+#include    <cstdint>
+#include    <functional>
+#include    <type_traits>
+
+namespace {
+    using namespace pentifica::trd;
+
+    using Cents = TickPrice<2>;
+}
+
+TEST(Test_TickPrice, Basic) {
+    static_assert(Cents::scale == 100);
+    static_assert(TickPrice<0, std::int32_t>::scale == 1);
+    static_assert(std::is_trivially_copyable_v<Cents>);
+    static_assert(sizeof(Cents) == sizeof(std::int64_t));
+
+    Cents const price{12345};
+    EXPECT_EQ(price.Ticks(), 12345);
+    EXPECT_DOUBLE_EQ(price.ToDouble(), 123.45);
+    EXPECT_EQ(Cents::FromDouble(123.45), price);
+    EXPECT_EQ(Cents::FromDouble(-0.015), Cents{-2});
+    EXPECT_EQ(static_cast<std::int64_t>(price), 12345);
+    EXPECT_EQ(TicksOf(price), 12345);
+    EXPECT_EQ(TicksOf(17), 17);
+}
+
+TEST(Test_TickPrice, Arithmetic) {
+    Cents price{100};
+    EXPECT_EQ(price + 1, Cents{101});
+    EXPECT_EQ(price - Cents{30}, Cents{70});
+    EXPECT_EQ(++price, Cents{101});
+    price -= Cents{1};
+    EXPECT_EQ(price, Cents{100});
+
+    EXPECT_LT(Cents{99}, price);
+    EXPECT_GT(Cents{101}, price);
+    EXPECT_NE(Cents{101}, price);
+    EXPECT_TRUE(std::greater<Cents>{}(Cents{2}, Cents{1}));
+}
@@ -0,0 +1,66 @@
+#include    <common/TscClock.h>
+
+#include    <gtest/gtest.h>
+
+#include    <chrono>
+#include    <cstdint>
+#include    <thread>
+
+namespace {
+    using namespace pentifica::trd;
+    using namespace std::chrono_literals;
+
+    /// @brief Returns how far the clock is from the system clock
+    std::chrono::nanoseconds Offset() {
+        auto const before{std::chrono::system_clock::now()};
+        auto const now{TscClock::now()};
+        auto const after{std::chrono::system_clock::now()};
+        if(now < before) return now - before;
+        if(now > after) return now - after;
+        return 0ns;
+    }
+}
+
+TEST(Test_TscClock, TracksWallClock) {
+    static_assert(std::is_same_v<TscClock::time_point, std::chrono::system_clock::time_point>);
+
+    for(int sample = 0; sample < 100; ++sample) {
+        EXPECT_LT(std::chrono::abs(Offset()), 1ms);
+    }
+    //  calibrated once, on request
+    auto const calibrated{TscClock::CalibrateOnce()};
+    EXPECT_EQ(TscClock::UsesTsc(), calibrated);
+    EXPECT_EQ(TscClock::UsesTsc(), TscClock::Frequency() != 0);
+    EXPECT_LT(std::chrono::abs(Offset()), 1ms);
+
+    //  only a resync may step the clock back, and by no more than the drift
+    auto previous{TscClock::now()};
+    for(int read = 0; read < 100'000; ++read) {
+        auto const now{TscClock::now()};
+        EXPECT_GE(now, previous - TscClock::max_drift);
+        previous = now;
+    }
+}
+
+TEST(Test_TscClock, Resync) {
+    TscClock::CalibrateOnce();
+    if(!TscClock::UsesTsc()) GTEST_SKIP() << "No invariant TSC";
+
+    auto const frequency{TscClock::Frequency()};
+    std::this_thread::sleep_for(TscClock::resync_interval + 100ms);
+    EXPECT_LT(std::chrono::abs(Offset()), 1ms);
+    EXPECT_TRUE(TscClock::UsesTsc());
+    //  refined over the longer interval, the rate barely moves
+    auto const refined{TscClock::Frequency()};
+    EXPECT_LT((refined > frequency ? refined - frequency : frequency - refined), frequency / 1000);
+}
+
+TEST(Test_TscClock, Fallback) {
+    TscClock::Disable();
+    EXPECT_FALSE(TscClock::UsesTsc());
+    EXPECT_EQ(TscClock::Frequency(), 0);
+    EXPECT_LT(std::chrono::abs(Offset()), 1ms);
+
+    TscClock::Calibrate();
+    EXPECT_LT(std::chrono::abs(Offset()), 1ms);
+}
@@ -0,0 +1,110 @@
+#include    <BookSnapshot.h>
+#include    <CompactOrder.h>
+
+#include    <gtest/gtest.h>
+
+#include    <filesystem>
+#include    <string>
+#include    <vector>
+
+namespace {
+    using namespace pentifica::trd::exch;
+
+    using TestOrder = CompactOrder<int>;
+
+    struct Config : EngineConfig {
+        using Ladders = TickLadders<256>;
+        using Orders = PooledOrders<256>;
+        using Keys = FixedIdKeys<256>;
+    };
+    auto callback = [](auto const&) {};
+    using Engine = MatchingEngine<TestOrder, decltype(callback), Config>;
+
+    std::string TempPath(std::string const& name) {
+        auto path{std::filesystem::temp_directory_path() / name};
+        std::filesystem::remove(path);
+        return path.string();
+    }
+
+    TestOrder MakeOrder(OrderSide side, int price, std::size_t quantity, std::string id,
+        OrderTimeInForce tif = OrderTimeInForce::GTC) {
+        return TestOrder(side, OrderType::LIMIT, tif, price, quantity, std::move(id));
+    }
+
+    std::vector<TestOrder> Resting(Engine const& engine) {
+        std::vector<TestOrder> orders;
+        engine.ForEachResting([&orders](TestOrder const& order) { orders.push_back(order); });
+        return orders;
+    }
+}
+
+TEST(Test_BookSnapshot, SaveAndLoad) {
+    auto const path{TempPath("test_book_snapshot.snp")};
+
+    Engine engine(callback);
+    engine.Buy(MakeOrder(OrderSide::BUY, 99, 10, "b1"));
+    engine.Buy(MakeOrder(OrderSide::BUY, 100, 5, "b2"));
+    engine.Buy(MakeOrder(OrderSide::BUY, 99, 7, "b3", OrderTimeInForce::DAY));
+    engine.Sell(MakeOrder(OrderSide::SELL, 102, 4, "s1"));
+    engine.Sell(MakeOrder(OrderSide::SELL, 101, 6, "s2"));
+    engine.Sell(MakeOrder(OrderSide::SELL, 101, 3, "s3"));
+    ASSERT_EQ(engine.Resting(), 6);
+
+    EXPECT_EQ(BookSnapshot<TestOrder>::Save(engine, path, 42), 6);
+
+    Engine loaded(callback);
+    EXPECT_EQ(BookSnapshot<TestOrder>::Load(loaded, path), 42);
+    EXPECT_EQ(loaded.Resting(), 6);
+
+    auto const before{Resting(engine)};
+    auto const after{Resting(loaded)};
+    ASSERT_EQ(after.size(), before.size());
+    std::vector<std::string> ids;
+    for(std::size_t index = 0; index < after.size(); ++index) {
+        ids.emplace_back(after[index].Id());
+        EXPECT_EQ(after[index].Price(), before[index].Price());
+        EXPECT_EQ(after[index].Quantity(), before[index].Quantity());
+        EXPECT_EQ(after[index].TIF(), before[index].TIF());
+        EXPECT_EQ(after[index].Time(), before[index].Time());
+    }
+    EXPECT_EQ(ids, (std::vector<std::string>{"b2", "b1", "b3", "s2", "s3", "s1"}));
+    EXPECT_EQ(loaded.BestBid(), engine.BestBid());
+    EXPECT_EQ(loaded.BestAsk(), engine.BestAsk());
+
+    //  time priority survives: the first order at 101 fills first
+    loaded.Buy(MakeOrder(OrderSide::BUY, 101, 6, "b4"));
+    EXPECT_EQ(Resting(loaded)[3].Id(), "s3");
+
+    EXPECT_THROW(loaded.Restore(TestOrder(OrderSide::BUY, OrderType::MARKET,
+        OrderTimeInForce::IOC, 0, 1, "m")), std::invalid_argument);
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(BookSnapshot<TestOrder>::Load(loaded, path), std::system_error);
+}
+
+TEST(Test_BookSnapshot, EngineState) {
+    auto const path{TempPath("test_book_snapshot_state.snp")};
+
+    Engine engine(callback);
+    auto iceberg{MakeOrder(OrderSide::SELL, 101, 20, "ice")};
+    iceberg.MaxShow(5);
+    engine.Sell(iceberg);
+    engine.Buy(MakeOrder(OrderSide::BUY, 101, 3, "b1"));
+    ASSERT_EQ(engine.BestAsk()->quantity_, 2);
+    engine.BeginAuction();
+    BookSnapshot<TestOrder>::Save(engine, path, 7);
+
+    //  the iceberg keeps what is left of its slice
+    Engine loaded(callback);
+    BookSnapshot<TestOrder>::Load(loaded, path);
+    EXPECT_EQ(loaded.BestAsk(), engine.BestAsk());
+    EXPECT_EQ(loaded.LastPrice(), 101);
+    EXPECT_TRUE(loaded.InAuction());
+
+    loaded.Uncross();
+    loaded.Buy(MakeOrder(OrderSide::BUY, 101, 4, "b2"));
+    EXPECT_EQ(loaded.BestAsk()->quantity_, 3);
+    EXPECT_EQ(Resting(loaded)[0].Quantity(), 13);
+
+    std::filesystem::remove(path);
+}
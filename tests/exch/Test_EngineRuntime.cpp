@@ -0,0 +1,160 @@
+#include    <EngineRuntime.h>
+#include    <Order.h>
+
+#include    <gtest/gtest.h>
+
+#include    <atomic>
+#include    <chrono>
+#include    <filesystem>
+#include    <memory>
+#include    <stdexcept>
+#include    <string>
+#include    <thread>
+#include    <vector>
+
+namespace {
+    using namespace pentifica::trd::exch;
+
+    using TestOrder = Order<int>;
+    using OnTrade = EngineOnTrade<TestOrder>;
+
+    struct Counter {
+        std::atomic<std::size_t>* traded_;
+        void operator()(OnTrade const& info) { *traded_ += info.quantity_; }
+        void operator()(auto const&) {}
+    };
+
+    using Runtime = EngineRuntime<TestOrder, Counter, EngineConfig, YieldingIdle>;
+}
+
+TEST(Test_EngineRuntime, Symbols) {
+    Runtime runtime(RuntimeOptions{.workers_ = 2});
+    std::atomic<std::size_t> traded{};
+
+    auto first = runtime.AddSymbol("AAA", Counter{&traded});
+    auto second = runtime.AddSymbol("BBB", Counter{&traded});
+    EXPECT_NE(first, second);
+    EXPECT_NE(runtime.WorkerOf(first), runtime.WorkerOf(second));
+    EXPECT_EQ(runtime.Find("BBB"), second);
+    EXPECT_FALSE(runtime.Find("CCC"));
+    EXPECT_THROW(runtime.AddSymbol("AAA", Counter{&traded}), std::invalid_argument);
+
+    runtime.Start();
+    EXPECT_THROW(runtime.AddSymbol("CCC", Counter{&traded}), std::logic_error);
+    runtime.Stop();
+}
+
+TEST(Test_EngineRuntime, Matching) {
+    constexpr std::size_t symbols{8};
+    constexpr std::size_t orders{500};
+
+    std::vector<std::atomic<std::size_t>> traded(symbols);
+    std::atomic<std::size_t> errors{};
+    Runtime runtime(RuntimeOptions{.workers_ = 3, .queue_capacity_ = 256},
+        [&errors](Runtime::SymbolId, std::exception const&) { ++errors; });
+
+    std::vector<Runtime::SymbolId> ids;
+    for(std::size_t index = 0; index < symbols; ++index) {
+        ids.push_back(runtime.AddSymbol("S" + std::to_string(index), Counter{&traded[index]}));
+    }
+
+    runtime.Start();
+
+    auto submit = [&runtime](Runtime::SymbolId symbol, Runtime::Request request) {
+        while(!runtime.Submit(symbol, request)) {}
+    };
+
+    for(std::size_t index = 0; index < orders; ++index) {
+        for(auto symbol : ids) {
+            auto const id{std::to_string(index)};
+            submit(symbol, {EngineAction::SELL, std::make_shared<TestOrder>(OrderSide::SELL,
+                OrderType::LIMIT, OrderTimeInForce::DAY, 100, 2, "s" + id)});
+            submit(symbol, {EngineAction::BUY, std::make_shared<TestOrder>(OrderSide::BUY,
+                OrderType::LIMIT, OrderTimeInForce::DAY, 100, 1, "b" + id)});
+            submit(symbol, {EngineAction::CANCEL, nullptr, "s" + id});
+        }
+    }
+    submit(ids[0], {EngineAction::UNKNOWN});
+
+    runtime.Stop();
+
+    for(auto& count : traded) EXPECT_EQ(count.load(), orders);
+    EXPECT_EQ(errors.load(), 1);
+}
+
+TEST(Test_EngineRuntime, Recover) {
+    auto const journal{(std::filesystem::temp_directory_path() / "test_runtime_recover.jrn").string()};
+    auto options = [&journal]() {
+        RuntimeOptions options{.workers_ = 2};
+        options.journal_ = journal;
+        options.journal_options_ = JournalOptions{4, 8, JournalSync::NONE};
+        return options;
+    };
+    for(std::size_t worker = 0; worker < 2; ++worker) std::filesystem::remove(journal + "." + std::to_string(worker));
+
+    std::atomic<std::size_t> traded{};
+    std::atomic<std::size_t> recovered{};
+    std::vector<std::size_t> resting;
+    {
+        Runtime runtime(options());
+        std::vector<Runtime::SymbolId> ids{runtime.AddSymbol("AAA", Counter{&traded}),
+            runtime.AddSymbol("BBB", Counter{&traded})};
+        runtime.Start();
+        auto submit = [&runtime](Runtime::SymbolId symbol, Runtime::Request request) {
+            while(!runtime.Submit(symbol, request)) {}
+        };
+        for(auto symbol : ids) {
+            for(int index = 0; index < 10; ++index) {
+                submit(symbol, {EngineAction::SELL, std::make_shared<TestOrder>(OrderSide::SELL,
+                    OrderType::LIMIT, OrderTimeInForce::DAY, 100 + index, 5, "s" + std::to_string(index))});
+            }
+            submit(symbol, {EngineAction::BUY, std::make_shared<TestOrder>(OrderSide::BUY,
+                OrderType::LIMIT, OrderTimeInForce::DAY, 101 + symbol, 7 + 3 * symbol, "b")});
+            submit(symbol, {EngineAction::CANCEL, nullptr, "s5"});
+        }
+        runtime.Stop();
+        for(auto symbol : ids) resting.push_back(runtime.Book(symbol).Resting());
+    }
+    EXPECT_EQ(traded.load(), 17);
+
+    Runtime runtime(options());
+    std::vector<Runtime::SymbolId> ids{runtime.AddSymbol("AAA", Counter{&recovered}),
+        runtime.AddSymbol("BBB", Counter{&recovered})};
+    EXPECT_EQ(runtime.Recover(), 24);
+    EXPECT_EQ(recovered.load(), traded.load());
+    for(auto symbol : ids) {
+        EXPECT_EQ(runtime.Book(symbol).Resting(), resting[symbol]);
+        EXPECT_EQ(runtime.Book(symbol).BestAsk()->price_, 101 + symbol);
+    }
+    EXPECT_EQ(runtime.Book(ids[0]).BestAsk()->quantity_, 3);
+    EXPECT_EQ(runtime.Book(ids[1]).BestAsk()->quantity_, 5);
+}
+
+TEST(Test_EngineRuntime, RecoverExpiries) {
+    auto const journal{(std::filesystem::temp_directory_path() / "test_runtime_expire.jrn").string()};
+    RuntimeOptions options{.workers_ = 1};
+    options.journal_ = journal;
+    options.journal_options_ = JournalOptions{4, 8, JournalSync::NONE};
+    std::filesystem::remove(journal + ".0");
+
+    std::atomic<std::size_t> traded{};
+    {
+        Runtime runtime(options);
+        auto const symbol{runtime.AddSymbol("AAA", Counter{&traded})};
+        auto gtd{std::make_shared<TestOrder>(OrderSide::SELL, OrderType::LIMIT, OrderTimeInForce::GTD, 100, 5, "gtd")};
+        gtd->ExpireTime(TestOrder::Clock::now() + std::chrono::milliseconds(5));
+        auto day{std::make_shared<TestOrder>(OrderSide::SELL, OrderType::LIMIT, OrderTimeInForce::DAY, 101, 5, "day")};
+        runtime.Start();
+        ASSERT_TRUE(runtime.Submit(symbol, {EngineAction::SELL, gtd}));
+        ASSERT_TRUE(runtime.Submit(symbol, {EngineAction::SELL, day}));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        runtime.Stop();
+        ASSERT_EQ(runtime.Book(symbol).Resting(), 1);
+    }
+
+    Runtime runtime(options);
+    auto const symbol{runtime.AddSymbol("AAA", Counter{&traded})};
+    EXPECT_EQ(runtime.Recover(), 3);
+    EXPECT_EQ(runtime.Book(symbol).Resting(), 1);
+    EXPECT_EQ(runtime.Book(symbol).BestAsk()->price_, 101);
+}
@@ -0,0 +1,84 @@
+#include    <EngineStats.h>
+
+#include    <gtest/gtest.h>
+
+#include    <atomic>
+#include    <cstdint>
+#include    <memory>
+#include    <random>
+#include    <thread>
+#include    <type_traits>
+
+namespace {
+    using namespace pentifica::trd::exch;
+
+    using Histogram = LatencyHistogram<4, 20>;
+}
+
+TEST(Test_EngineStats, Buckets) {
+    static_assert(Histogram::buckets == 17 * 16);
+    //  exact below 2^5
+    for(std::uint64_t value = 0; value < 32; ++value) {
+        EXPECT_EQ(Histogram::Index(value), value);
+        EXPECT_EQ(Histogram::Highest(Histogram::Index(value)), value);
+    }
+    //  within 1/16 above it, each value inside its bucket
+    for(std::uint64_t value = 32; value < (1 << 20); value += 7) {
+        auto const highest{Histogram::Highest(Histogram::Index(value))};
+        EXPECT_GE(highest, value);
+        EXPECT_LE(highest - value, value / 16);
+    }
+    EXPECT_EQ(Histogram::Index(~std::uint64_t{}), Histogram::buckets - 1);
+}
+
+TEST(Test_EngineStats, Percentiles) {
+    auto histogram{std::make_unique<Histogram>()};
+    for(std::uint64_t value = 1; value <= 1000; ++value) histogram->Record(value);
+
+    auto const snapshot{histogram->Take()};
+    EXPECT_EQ(snapshot.count_, 1000);
+    EXPECT_EQ(snapshot.sum_, 500500);
+    EXPECT_EQ(snapshot.max_, 1000);
+    auto within = [](std::uint64_t actual, std::uint64_t expected) {
+        return actual >= expected && actual - expected <= expected / 16;
+    };
+    EXPECT_TRUE(within(Histogram::ValueAt(snapshot, 50), 500));
+    EXPECT_TRUE(within(Histogram::ValueAt(snapshot, 99), 990));
+    EXPECT_EQ(Histogram::ValueAt(snapshot, 100), 1000);
+    EXPECT_EQ(Histogram::ValueAt(Histogram::Snapshot{}, 50), 0);
+}
+
+TEST(Test_EngineStats, ConcurrentSnapshot) {
+    static_assert(std::is_empty_v<NoEngineStats>);
+
+    auto stats{std::make_unique<EngineStats<Histogram>>()};
+    constexpr std::uint64_t operations{100'000};
+    std::atomic<bool> done{};
+    std::thread monitor([&] {
+        std::uint64_t last{};
+        while(!done.load()) {
+            auto const snapshot{stats->Take()};
+            //  counts only ever grow
+            EXPECT_GE(snapshot.fills_, last);
+            last = snapshot.fills_;
+        }
+    });
+    for(std::uint64_t operation = 0; operation < operations; ++operation) {
+        auto timer{stats->Start(EngineOperation::CANCEL, [operation] {
+            return std::pair<std::uint64_t, std::uint64_t>{operation, 2};
+        })};
+        stats->Filled();
+        stats->Swept(operation % 3);
+    }
+    done = true;
+    monitor.join();
+
+    auto const snapshot{stats->Take()};
+    EXPECT_EQ(snapshot.Of(EngineOperation::CANCEL).count_, operations);
+    EXPECT_EQ(snapshot.Of(EngineOperation::FILL).count_, 0);
+    EXPECT_EQ(snapshot.fills_, operations);
+    EXPECT_EQ(snapshot.sweeps_, operations - (operations + 2) / 3);
+    EXPECT_EQ(snapshot.max_levels_swept_, 2);
+    EXPECT_EQ(snapshot.resting_, operations - 1);
+    EXPECT_EQ(snapshot.levels_, 2);
+}
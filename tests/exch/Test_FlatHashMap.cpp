@@ -0,0 +1,88 @@
+#include    <FlatHashMap.h>
+
+#include    <gtest/gtest.h>
+
+#include    <cstdint>
+#include    <random>
+#include    <unordered_map>
+
+namespace {
+    using namespace pentifica::trd::exch;
+    using Map = FlatHashMap<std::uint64_t, int>;
+}
+
+TEST(Test_FlatHashMap, Basic) {
+    Map map;
+    EXPECT_EQ(map.Size(), 0);
+    EXPECT_EQ(map.Find(7), nullptr);
+
+    auto [value, added] = map.TryEmplace(7);
+    EXPECT_TRUE(added);
+    *value = 70;
+
+    auto [again, added_again] = map.TryEmplace(7);
+    EXPECT_FALSE(added_again);
+    EXPECT_EQ(*again, 70);
+    EXPECT_EQ(map.Size(), 1);
+
+    map.Erase(7);
+    EXPECT_EQ(map.Find(7), nullptr);
+    EXPECT_EQ(map.Size(), 0);
+    map.Erase(7);
+}
+
+TEST(Test_FlatHashMap, IncrementalGrowth) {
+    Map map(8);
+    bool migrated{};
+    for(std::uint64_t key = 0; key < 1000; ++key) {
+        *map.TryEmplace(key).first = static_cast<int>(key);
+        migrated |= map.Migrating();
+        //  everything inserted so far is reachable mid-migration
+        if(key % 97 == 0) {
+            for(std::uint64_t check = 0; check <= key; ++check) {
+                auto* value = map.Find(check);
+                ASSERT_NE(value, nullptr);
+                EXPECT_EQ(*value, static_cast<int>(check));
+            }
+        }
+    }
+    EXPECT_TRUE(migrated);
+    EXPECT_EQ(map.Size(), 1000);
+}
+
+TEST(Test_FlatHashMap, MatchesReference) {
+    Map map(4);
+    std::unordered_map<std::uint64_t, int> reference;
+    std::mt19937_64 rng(12345);
+    std::uniform_int_distribution<std::uint64_t> keys(0, 2000);
+
+    for(int step = 0; step < 50000; ++step) {
+        auto const key = keys(rng);
+        switch(rng() % 3) {
+            case 0:
+                *map.TryEmplace(key).first = step;
+                reference[key] = step;
+                break;
+            case 1:
+                map.Erase(key);
+                reference.erase(key);
+                break;
+            default: {
+                auto* value = map.Find(key);
+                auto index = reference.find(key);
+                ASSERT_EQ(value != nullptr, index != reference.end());
+                if(value) {
+                    EXPECT_EQ(*value, index->second);
+                }
+            }
+        }
+        ASSERT_EQ(map.Size(), reference.size());
+    }
+
+    std::size_t visited{};
+    map.ForEach([&](std::uint64_t key, int value) {
+        ++visited;
+        EXPECT_EQ(reference.at(key), value);
+    });
+    EXPECT_EQ(visited, reference.size());
+}
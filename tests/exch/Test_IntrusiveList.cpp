@@ -0,0 +1,91 @@
+#include    <IntrusiveList.h>
+
+#include    <gtest/gtest.h>
+
+#include    <vector>
+
+namespace {
+    using namespace pentifica::trd::exch;
+
+    struct FirstTag;
+    struct SecondTag;
+
+    struct Item : IntrusiveLink<Item, FirstTag>, IntrusiveLink<Item, SecondTag> {
+        explicit Item(int value) : value_{value} {}
+        int value_;
+    };
+
+    using FirstList = IntrusiveList<Item, FirstTag>;
+    using SecondList = IntrusiveList<Item, SecondTag>;
+
+    template<typename List>
+    std::vector<int> Values(List const& list) {
+        std::vector<int> result;
+        for(auto const& item : list) result.push_back(item.value_);
+        return result;
+    }
+}
+
+TEST(Test_IntrusiveList, Empty) {
+    FirstList list;
+    EXPECT_TRUE(list.Empty());
+    EXPECT_EQ(list.Size(), 0);
+    EXPECT_TRUE(list.begin() == list.end());
+}
+
+TEST(Test_IntrusiveList, Fifo) {
+    Item one{1}, two{2}, three{3};
+    FirstList list;
+    list.PushBack(one);
+    list.PushBack(two);
+    list.PushBack(three);
+
+    EXPECT_EQ(list.Size(), 3);
+    EXPECT_EQ(Values(list), (std::vector<int>{1, 2, 3}));
+
+    list.PopFront();
+    EXPECT_EQ(&list.Front(), &two);
+    EXPECT_EQ(&list.Back(), &three);
+    EXPECT_EQ(Values(list), (std::vector<int>{2, 3}));
+}
+
+TEST(Test_IntrusiveList, EraseAnywhere) {
+    Item one{1}, two{2}, three{3}, four{4};
+    FirstList list;
+    for(auto* item : {&one, &two, &three, &four}) list.PushBack(*item);
+
+    list.Erase(two);
+    EXPECT_EQ(Values(list), (std::vector<int>{1, 3, 4}));
+    list.Erase(four);
+    EXPECT_EQ(Values(list), (std::vector<int>{1, 3}));
+    list.Erase(one);
+    EXPECT_EQ(Values(list), (std::vector<int>{3}));
+    list.Erase(three);
+    EXPECT_TRUE(list.Empty());
+
+    list.PushBack(two);
+    EXPECT_EQ(Values(list), (std::vector<int>{2}));
+}
+
+TEST(Test_IntrusiveList, MultipleMembership) {
+    Item one{1}, two{2}, three{3};
+    FirstList first;
+    SecondList second;
+    for(auto* item : {&one, &two, &three}) first.PushBack(*item);
+    for(auto* item : {&three, &one}) second.PushBack(*item);
+
+    first.Erase(one);
+    EXPECT_EQ(Values(first), (std::vector<int>{2, 3}));
+    EXPECT_EQ(Values(second), (std::vector<int>{3, 1}));
+}
+
+TEST(Test_IntrusiveList, Move) {
+    Item one{1}, two{2};
+    FirstList list;
+    list.PushBack(one);
+    list.PushBack(two);
+
+    FirstList moved{std::move(list)};
+    EXPECT_TRUE(list.Empty());
+    EXPECT_EQ(Values(moved), (std::vector<int>{1, 2}));
+}
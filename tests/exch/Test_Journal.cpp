@@ -0,0 +1,159 @@
+#include    <Journal.h>
+#include    <CompactOrder.h>
+#include    <Order.h>
+
+#include    <gtest/gtest.h>
+
+#include    <chrono>
+#include    <filesystem>
+#include    <string>
+#include    <vector>
+
+namespace {
+    using namespace pentifica::trd::exch;
+
+    using TestOrder = CompactOrder<int>;
+    using SharedOrder = Order<int>;
+
+    struct Config : EngineConfig {
+        using Orders = PooledOrders<1024>;
+        using Keys = IntegerKeys<>;
+    };
+    auto callback = [](auto const&) {};
+    using Engine = MatchingEngine<TestOrder, decltype(callback), Config>;
+    using Level = Engine::Level;
+
+    std::string TempPath(std::string const& name) {
+        auto path{std::filesystem::temp_directory_path() / name};
+        std::filesystem::remove(path);
+        return path.string();
+    }
+
+    TestOrder MakeOrder(OrderSide side, int price, std::size_t quantity, std::uint64_t key) {
+        TestOrder order(side, OrderType::LIMIT, OrderTimeInForce::GTC, price, quantity, "id" + std::to_string(key));
+        order.Key(key);
+        return order;
+    }
+
+    std::vector<Level> Depth(Engine const& engine, OrderSide side) {
+        std::vector<Level> levels(16);
+        levels.resize(side == OrderSide::BUY ? engine.BidDepth(levels) : engine.AskDepth(levels));
+        return levels;
+    }
+}
+
+TEST(Test_Journal, ReplayRebuildsBook) {
+    auto const path{TempPath("test_journal_replay.jrn")};
+    using Request = Engine::Request;
+    Engine live(callback);
+    {
+        Journal<TestOrder, Config::Keys> journal(path, JournalOptions{4, 8, JournalSync::NONE});
+        std::vector<Request> requests;
+        for(std::uint64_t key = 1; key <= 40; ++key) {
+            auto const side{key % 2 ? OrderSide::BUY : OrderSide::SELL};
+            auto const price{side == OrderSide::BUY ? 90 + int(key % 7) : 97 + int(key % 5)};
+            auto order{MakeOrder(side, price, key, key)};
+            if(key % 10 == 0) order.TIF(OrderTimeInForce::DAY);
+            requests.push_back({side == OrderSide::BUY ? EngineAction::BUY : EngineAction::SELL, order});
+        }
+        requests.push_back({EngineAction::CANCEL, {}, 3});
+        requests.push_back({EngineAction::REVISE, MakeOrder(OrderSide::SELL, 99, 100, 4)});
+        requests.push_back({EngineAction::END_OF_DAY});
+
+        for(auto& request : requests) {
+            journal.Append(request);
+            live.Apply(request);
+        }
+        EXPECT_EQ(journal.Written(), 43);
+        journal.Sync();
+        EXPECT_EQ(journal.Committed(), 43);
+    }
+
+    JournalReader<TestOrder, Config::Keys> reader(path);
+    ASSERT_EQ(reader.Size(), 43);
+    EXPECT_EQ(reader[0].sequence_, 1);
+    EXPECT_EQ(reader[0].id_.View(), "id1");
+    EXPECT_EQ(reader[40].action_, EngineAction::CANCEL);
+    EXPECT_EQ(reader[40].key_, 3);
+    EXPECT_EQ(reader[42].action_, EngineAction::END_OF_DAY);
+
+    Engine rebuilt(callback);
+    EXPECT_EQ(reader.Replay(rebuilt), 43);
+    EXPECT_EQ(rebuilt.Resting(), live.Resting());
+    EXPECT_EQ(Depth(rebuilt, OrderSide::BUY), Depth(live, OrderSide::BUY));
+    EXPECT_EQ(Depth(rebuilt, OrderSide::SELL), Depth(live, OrderSide::SELL));
+    EXPECT_FALSE(Depth(live, OrderSide::SELL).empty());
+
+    std::filesystem::remove(path);
+}
+
+TEST(Test_Journal, ReplayExpires) {
+    auto const path{TempPath("test_journal_expire.jrn")};
+    using Request = Engine::Request;
+    auto const start{TestOrder::TimePoint{} + std::chrono::hours(1)};
+    Engine live(callback);
+    {
+        Journal<TestOrder, Config::Keys> journal(path, JournalOptions{4, 8, JournalSync::NONE});
+        auto gtd{MakeOrder(OrderSide::BUY, 100, 5, 1)};
+        gtd.TIF(OrderTimeInForce::GTD);
+        gtd.ExpireTime(start + std::chrono::seconds(1));
+        TestOrder expiry;
+        expiry.Time(start + std::chrono::seconds(2));
+
+        std::vector<Request> requests{
+            {EngineAction::BUY, gtd},
+            {EngineAction::EXPIRE, expiry},
+            {EngineAction::SELL, MakeOrder(OrderSide::SELL, 100, 5, 2)},
+        };
+        for(auto& request : requests) {
+            journal.Append(request);
+            live.Apply(request);
+        }
+    }
+    EXPECT_FALSE(live.BestBid());
+    ASSERT_TRUE(live.BestAsk());
+
+    JournalReader<TestOrder, Config::Keys> reader(path);
+    ASSERT_EQ(reader.Size(), 3);
+    EXPECT_EQ(reader[1].action_, EngineAction::EXPIRE);
+
+    Engine rebuilt(callback);
+    EXPECT_EQ(reader.Replay(rebuilt), 3);
+    EXPECT_EQ(rebuilt.Resting(), live.Resting());
+    EXPECT_EQ(Depth(rebuilt, OrderSide::BUY), Depth(live, OrderSide::BUY));
+    EXPECT_EQ(Depth(rebuilt, OrderSide::SELL), Depth(live, OrderSide::SELL));
+
+    std::filesystem::remove(path);
+}
+
+TEST(Test_Journal, ReopenAppends) {
+    auto const path{TempPath("test_journal_reopen.jrn")};
+    {
+        Journal<SharedOrder> journal(path);
+        journal.Append(EngineAction::BUY, SharedOrder(OrderSide::BUY, OrderType::LIMIT, OrderTimeInForce::GTC,
+            100, 5, "id1"));
+    }
+    {
+        Journal<SharedOrder> journal(path);
+        EXPECT_EQ(journal.Committed(), 1);
+        EXPECT_EQ(journal.Append(std::string("id1")), 2);
+        EXPECT_THROW(journal.Append(EngineAction::BUY, SharedOrder(OrderSide::BUY, OrderType::LIMIT,
+            OrderTimeInForce::DAY, 100, 1, std::string(32, 'x'))), std::length_error);
+    }
+
+    JournalReader<SharedOrder> reader(path);
+    ASSERT_EQ(reader.Size(), 2);
+    EXPECT_EQ(reader[1].action_, EngineAction::CANCEL);
+    EXPECT_EQ(reader[1].id_.View(), "id1");
+    auto const order{reader.ToOrder(reader[0])};
+    EXPECT_EQ(order.Id(), "id1");
+    EXPECT_EQ(order.Quantity(), 5);
+
+    auto callback = [](auto const&) {};
+    MatchingEngine<SharedOrder, decltype(callback)> engine(callback);
+    EXPECT_EQ(reader.Replay(engine), 2);
+    EXPECT_FALSE(engine.BestBid());
+
+    EXPECT_THROW(JournalReader<Order<double>>{path}, std::runtime_error);
+    std::filesystem::remove(path);
+}
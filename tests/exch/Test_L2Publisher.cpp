@@ -0,0 +1,138 @@
+#include    <L2Publisher.h>
+#include    <CompactOrder.h>
+
+#include    <gtest/gtest.h>
+
+#include    <atomic>
+#include    <thread>
+#include    <vector>
+
+namespace {
+    using namespace pentifica::trd::exch;
+
+    using TestOrder = CompactOrder<int>;
+    using Publisher = L2Publisher<int>;
+    using Update = Publisher::Update;
+
+    struct Callback {
+        void operator()(EngineOnLevel<int> const& signal) { publisher_(signal); }
+        void operator()(EngineOnFlush const& signal) { publisher_(signal); }
+        template<typename Signal>
+        void operator()(Signal const&) {}
+
+        Publisher& publisher_;
+    };
+
+    struct Config : EngineConfig {
+        using Orders = PooledOrders<64>;
+        using Keys = FixedIdKeys<64>;
+    };
+    using Engine = MatchingEngine<TestOrder, Callback, Config>;
+    using Request = Engine::Request;
+
+    TestOrder MakeOrder(OrderSide side, int price, std::size_t quantity, std::string id) {
+        return TestOrder(side, OrderType::LIMIT, OrderTimeInForce::DAY, price, quantity, std::move(id));
+    }
+
+    std::vector<Update> Collect(Publisher& publisher, Publisher::Subscription& subscription) {
+        publisher.Poll();
+        std::vector<Update> updates;
+        subscription.Drain([&updates](Update const& update) { updates.push_back(update); }, 1024);
+        return updates;
+    }
+}
+
+TEST(Test_L2Publisher, ConflatesWithinBatch) {
+    Publisher publisher;
+    auto& subscription{publisher.Subscribe(64)};
+    Engine engine(Callback{publisher});
+
+    std::vector<Request> batch{
+        {EngineAction::SELL, MakeOrder(OrderSide::SELL, 101, 10, "s1")},
+        {EngineAction::SELL, MakeOrder(OrderSide::SELL, 101, 5, "s2")},
+        {EngineAction::BUY, MakeOrder(OrderSide::BUY, 99, 5, "b1")},
+        {EngineAction::BUY, MakeOrder(OrderSide::BUY, 98, 5, "b2")},
+        {EngineAction::CANCEL, {}, Engine::KeyType("b2")},
+    };
+    engine.Submit(batch);
+
+    auto updates{Collect(publisher, subscription)};
+    ASSERT_EQ(updates.size(), 2);
+    EXPECT_EQ(updates[0].action_, L2Action::NEW);
+    EXPECT_EQ(updates[0].side_, OrderSide::SELL);
+    EXPECT_EQ(updates[0].price_, 101);
+    EXPECT_EQ(updates[0].quantity_, 15);
+    EXPECT_EQ(updates[0].orders_, 2);
+    EXPECT_EQ(updates[0].sequence_, 1);
+    EXPECT_EQ(updates[1].action_, L2Action::NEW);
+    EXPECT_EQ(updates[1].price_, 99);
+
+    std::vector<Request> trades{
+        {EngineAction::BUY, MakeOrder(OrderSide::BUY, 101, 3, "b3")},
+        {EngineAction::BUY, MakeOrder(OrderSide::BUY, 101, 3, "b4")},
+        {EngineAction::SELL, MakeOrder(OrderSide::SELL, 99, 5, "s3")},
+    };
+    engine.Submit(trades);
+
+    updates = Collect(publisher, subscription);
+    ASSERT_EQ(updates.size(), 2);
+    EXPECT_EQ(updates[0].action_, L2Action::CHANGE);
+    EXPECT_EQ(updates[0].quantity_, 9);
+    EXPECT_EQ(updates[1].action_, L2Action::DELETE);
+    EXPECT_EQ(updates[1].price_, 99);
+    EXPECT_EQ(updates[1].sequence_, 2);
+}
+
+TEST(Test_L2Publisher, SlowConsumerGetsSnapshot) {
+    Publisher publisher;
+    auto& fast{publisher.Subscribe(64)};
+    auto& slow{publisher.Subscribe(8)};
+    Engine engine(Callback{publisher});
+
+    for(int round = 0; round < 3; ++round) {
+        for(int price = 100; price < 103; ++price) {
+            engine.Sell(MakeOrder(OrderSide::SELL, price, 1, std::to_string(round * 10 + price)));
+        }
+        engine.Flush(3);
+    }
+    publisher.Poll();
+    EXPECT_EQ(slow.Conflations(), 1);
+    EXPECT_EQ(Collect(publisher, fast).size(), 9);
+    EXPECT_EQ(Collect(publisher, slow).size(), 6);
+
+    engine.Buy(MakeOrder(OrderSide::BUY, 90, 2, "b1"));
+    engine.Flush(1);
+    auto updates{Collect(publisher, slow)};
+    ASSERT_EQ(updates.size(), 5);
+    EXPECT_EQ(updates[0].action_, L2Action::SNAPSHOT);
+    EXPECT_EQ(updates[1].side_, OrderSide::BUY);
+    EXPECT_EQ(updates[1].price_, 90);
+    EXPECT_EQ(updates[2].price_, 100);
+    EXPECT_EQ(updates[4].price_, 102);
+    EXPECT_EQ(updates[4].quantity_, 3);
+    EXPECT_EQ(Collect(publisher, fast).size(), 1);
+}
+
+TEST(Test_L2Publisher, PublishesOnItsOwnThread) {
+    Publisher publisher(4);
+    auto& subscription{publisher.Subscribe(1024)};
+    Engine engine(Callback{publisher});
+
+    std::atomic<bool> done{};
+    std::thread thread([&publisher, &done]() {
+        while(!done.load()) publisher.Poll();
+        publisher.Poll();
+    });
+    for(int price = 100; price < 150; ++price) {
+        engine.Sell(MakeOrder(OrderSide::SELL, price, 1, std::to_string(price)));
+        engine.Flush(1);
+    }
+    done = true;
+    thread.join();
+
+    auto updates{Collect(publisher, subscription)};
+    ASSERT_EQ(updates.size(), 50);
+    EXPECT_EQ(updates.back().price_, 149);
+    EXPECT_EQ(updates.back().sequence_, 50);
+    EXPECT_EQ(publisher.Sequence(), 50);
+}
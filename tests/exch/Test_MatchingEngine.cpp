@@ -1,13 +1,18 @@
 #include    <Order.h>
+#include    <CompactOrder.h>
 #include    <MatchingEngine.h>
+#include    <Ring.h>
 
 #include    <gtest/gtest.h>
 
+#include    <functional>
 #include    <iostream>
+#include    <memory>
 #include    <unordered_map>
 #include    <unordered_set>
 #include    <string>
 #include    <random>
+#include    <vector>
 
 template<typename ...Ts>
 struct Overload : Ts... {
@@ -22,6 +27,8 @@ namespace {
     using OnTrade = EngineOnTrade<TestOrder>;
     using OnCancel = EngineOnCancel<TestOrder>;
     using OnRevise = EngineOnRevise<TestOrder>;
+    /// @brief Pooled orders own no heap storage
+    using PoolOrder = CompactOrder<int>;
 
     struct OrderSpec {
         std::string id_;
@@ -297,4 +304,1189 @@ TEST(Test_MatchingEngine, IOCTrade) {
         engine.Cancel(buy->Id());
         EXPECT_FALSE(cancel_id == buy->Id());
     }
-}
\ No newline at end of file
+}
+TEST(Test_MatchingEngine, TimePriority) {
+    using namespace pentifica::trd::exch;
+
+    std::vector<std::string> filled;
+    auto callback = Overload {
+        [&filled](OnTrade const& info) { filled.push_back(info.existing_order_->Id()); },
+        [](auto) {}
+    };
+
+    using Callback = decltype(callback);
+
+    MatchingEngine<TestOrder, Callback> engine(callback);
+
+    std::vector<std::string> ids;
+    for(int index = 0; index < 6; ++index) {
+        ids.push_back("Resting" + std::to_string(index));
+        auto order = std::make_shared<TestOrder>(OrderSide::SELL, OrderType::LIMIT,
+            OrderTimeInForce::DAY, 100, 10, ids.back());
+        engine.Sell(order);
+    }
+
+    engine.Cancel(ids[0]);
+    engine.Cancel(ids[3]);
+    engine.Cancel(ids[5]);
+
+    auto buy = std::make_shared<TestOrder>(OrderSide::BUY, OrderType::LIMIT,
+        OrderTimeInForce::IOC, 100, 60, GenerateId());
+    engine.Buy(buy);
+
+    std::vector<std::string> expected{ids[1], ids[2], ids[4]};
+    EXPECT_EQ(filled, expected);
+    EXPECT_EQ(buy->Quantity(), 30);
+}
+
+TEST(Test_MatchingEngine, DeepLevelCancel) {
+    using namespace pentifica::trd::exch;
+
+    std::size_t cancelled{};
+    std::size_t traded{};
+    auto callback = Overload {
+        [&cancelled](OnCancel const&) { ++cancelled; },
+        [&traded](OnTrade const& info) { traded += info.quantity_; },
+        [](auto) {}
+    };
+
+    using Callback = decltype(callback);
+
+    MatchingEngine<TestOrder, Callback> engine(callback);
+
+    constexpr std::size_t depth{10000};
+    for(std::size_t index = 0; index < depth; ++index) {
+        auto order = std::make_shared<TestOrder>(OrderSide::BUY, OrderType::LIMIT,
+            OrderTimeInForce::GTC, 50, 1, std::to_string(index));
+        engine.Buy(order);
+    }
+
+    for(std::size_t index = 0; index < depth; index += 2) {
+        engine.Cancel(std::to_string(index));
+    }
+    engine.Cancel("unknown");
+    EXPECT_EQ(cancelled, depth / 2);
+
+    auto sell = std::make_shared<TestOrder>(OrderSide::SELL, OrderType::MARKET,
+        OrderTimeInForce::IOC, 0, depth, GenerateId());
+    engine.Sell(sell);
+    EXPECT_EQ(traded, depth / 2);
+    EXPECT_EQ(sell->Quantity(), depth / 2);
+}
+
+TEST(Test_MatchingEngine, TickLadder) {
+    using namespace pentifica::trd::exch;
+
+    std::vector<std::pair<std::string, std::size_t>> trades;
+    std::vector<std::string> rejects;
+    auto callback = Overload {
+        [&trades](OnTrade const& info) {
+            trades.emplace_back(info.existing_order_->Id(), info.quantity_);
+        },
+        [&rejects](EngineOnReject<TestOrder> const& info) {
+            EXPECT_EQ(info.reason_, RejectReason::PRICE_OUT_OF_RANGE);
+            rejects.push_back(info.order_.Id());
+        },
+        [](auto) {}
+    };
+
+    using Callback = decltype(callback);
+    struct Config : EngineConfig {
+        using Ladders = TickLadders<256>;
+    };
+
+    MatchingEngine<TestOrder, Callback, Config> engine(callback);
+
+    OrderSpec const resting[] = {
+        { "a", 105, 10, OrderSide::SELL },
+        { "b", 101, 10, OrderSide::SELL },
+        { "c", 103, 10, OrderSide::SELL },
+        { "d", 101, 10, OrderSide::SELL },
+    };
+    for(auto const& [id, price, quantity, side] : resting) {
+        auto order = std::make_shared<TestOrder>(side, OrderType::LIMIT,
+            OrderTimeInForce::DAY, price, quantity, id);
+        engine.Sell(order);
+    }
+
+    engine.Cancel("c");
+
+    auto buy = std::make_shared<TestOrder>(OrderSide::BUY, OrderType::LIMIT,
+        OrderTimeInForce::DAY, 104, 25, "e");
+    engine.Buy(buy);
+
+    std::vector<std::pair<std::string, std::size_t>> expected{{"b", 10}, {"d", 10}};
+    EXPECT_EQ(trades, expected);
+    EXPECT_EQ(buy->Quantity(), 5);
+
+    auto far = std::make_shared<TestOrder>(OrderSide::BUY, OrderType::LIMIT,
+        OrderTimeInForce::DAY, 104 - 256, 1, "f");
+    engine.Buy(far);
+    EXPECT_EQ(rejects, std::vector<std::string>{"f"});
+    EXPECT_EQ(engine.BestBid()->price_, 104);
+    auto revised = std::make_shared<TestOrder>(OrderSide::BUY, OrderType::LIMIT,
+        OrderTimeInForce::DAY, 104 - 256, 5, "e");
+    engine.Revise(revised);
+    EXPECT_EQ(rejects, (std::vector<std::string>{"f", "e"}));
+    EXPECT_EQ(engine.BestBid()->price_, 104);
+
+    trades.clear();
+    auto sell = std::make_shared<TestOrder>(OrderSide::SELL, OrderType::MARKET,
+        OrderTimeInForce::IOC, 0, 10, "g");
+    engine.Sell(sell);
+    expected = {{"e", 5}};
+    EXPECT_EQ(trades, expected);
+    EXPECT_EQ(sell->Quantity(), 5);
+}
+
+TEST(Test_MatchingEngine, PooledOrders) {
+    using namespace pentifica::trd::exch;
+
+    struct Config : EngineConfig {
+        using Orders = PooledOrders<2>;
+        using Keys = FixedIdKeys<16>;
+    };
+
+    using PoolOnTrade = EngineOnTrade<PoolOrder, PoolOrder*>;
+    using PoolOnCancel = EngineOnCancel<PoolOrder, PoolOrder*>;
+    using PoolOnReject = EngineOnReject<PoolOrder>;
+
+    std::vector<std::string> rejected;
+    std::vector<std::string> cancelled;
+    std::size_t traded{};
+    auto callback = Overload {
+        [&rejected](PoolOnReject const& info) {
+            EXPECT_EQ(info.reason_, RejectReason::POOL_EXHAUSTED);
+            rejected.emplace_back(info.order_.Id());
+        },
+        [&cancelled](PoolOnCancel const& info) { cancelled.emplace_back(info.order_->Id()); },
+        [&traded](PoolOnTrade const& info) { traded += info.quantity_; },
+        [](auto) {}
+    };
+
+    using Callback = decltype(callback);
+
+    using Engine = MatchingEngine<PoolOrder, Callback, Config>;
+    Engine engine(callback);
+    static_assert(!Engine::shared_orders);
+
+    auto order = [](OrderSide side, OrderTimeInForce tif, int price, std::string_view id) {
+        return PoolOrder(side, OrderType::LIMIT, tif, price, 10, id);
+    };
+
+    EXPECT_TRUE(engine.Sell(order(OrderSide::SELL, OrderTimeInForce::DAY, 100, "a")));
+    EXPECT_TRUE(engine.Sell(order(OrderSide::SELL, OrderTimeInForce::DAY, 101, "b")));
+    EXPECT_FALSE(engine.Sell(order(OrderSide::SELL, OrderTimeInForce::DAY, 102, "c")));
+    EXPECT_EQ(rejected, std::vector<std::string>{"c"});
+
+    //  a filled resting order returns its slot to the pool
+    EXPECT_FALSE(engine.Buy(order(OrderSide::BUY, OrderTimeInForce::IOC, 100, "d")));
+    engine.Cancel(Engine::KeyType("a"));
+    EXPECT_TRUE(engine.Buy(order(OrderSide::BUY, OrderTimeInForce::IOC, 101, "d")));
+    EXPECT_EQ(traded, 10);
+    EXPECT_TRUE(engine.Sell(order(OrderSide::SELL, OrderTimeInForce::DAY, 102, "c")));
+    EXPECT_TRUE(engine.Sell(order(OrderSide::SELL, OrderTimeInForce::DAY, 103, "e")));
+
+    EXPECT_TRUE(engine.Revise(order(OrderSide::SELL, OrderTimeInForce::DAY, 104, "e")));
+    EXPECT_FALSE(engine.Revise(order(OrderSide::SELL, OrderTimeInForce::DAY, 104, "x")));
+
+    engine.Cancel(Engine::KeyType("c"));
+    engine.Cancel(Engine::KeyType("e"));
+    EXPECT_EQ(cancelled, (std::vector<std::string>{"a", "c", "e"}));
+}
+
+TEST(Test_MatchingEngine, IntegerKeys) {
+    using namespace pentifica::trd::exch;
+
+    struct Config : EngineConfig {
+        using Keys = IntegerKeys<4>;
+    };
+
+    std::vector<std::uint64_t> cancelled;
+    std::vector<std::uint64_t> filled;
+    auto callback = Overload {
+        [&cancelled](OnCancel const& info) { cancelled.push_back(info.order_->Key()); },
+        [&filled](OnTrade const& info) { filled.push_back(info.existing_order_->Key()); },
+        [](auto) {}
+    };
+
+    using Callback = decltype(callback);
+
+    MatchingEngine<TestOrder, Callback, Config> engine(callback);
+
+    constexpr std::uint64_t count{1000};
+    for(std::uint64_t key = 1; key <= count; ++key) {
+        auto order = std::make_shared<TestOrder>(OrderSide::SELL, OrderType::LIMIT,
+            OrderTimeInForce::GTC, 100 + static_cast<int>(key % 5), 1, "");
+        order->Key(key);
+        engine.Sell(order);
+    }
+
+    for(std::uint64_t key = 1; key <= count; key += 2) engine.Cancel(key);
+    engine.Cancel(count + 1);
+    EXPECT_EQ(cancelled.size(), count / 2);
+
+    auto buy = std::make_shared<TestOrder>(OrderSide::BUY, OrderType::LIMIT,
+        OrderTimeInForce::IOC, 100, count, "");
+    engine.Buy(buy);
+
+    std::vector<std::uint64_t> expected;
+    for(std::uint64_t key = 10; key <= count; key += 10) expected.push_back(key);
+    EXPECT_EQ(filled, expected);
+
+    cancelled.clear();
+    for(std::uint64_t key = 1; key <= count; ++key) engine.Cancel(key);
+    EXPECT_EQ(cancelled.size(), count / 2 - expected.size());
+}
+
+TEST(Test_MatchingEngine, BatchSubmit) {
+    using namespace pentifica::trd::exch;
+
+    std::vector<std::string> events;
+    auto callback = Overload {
+        [&events](OnTrade const& info) { events.push_back("trade " + info.existing_order_->Id()); },
+        [&events](OnCancel const& info) { events.push_back("cancel " + info.order_->Id()); },
+        [&events](EngineOnFlush const& info) { events.push_back("flush " + std::to_string(info.requests_)); },
+        [](auto) {}
+    };
+
+    using Callback = decltype(callback);
+    using Engine = MatchingEngine<TestOrder, Callback>;
+    using Request = Engine::Request;
+
+    Engine engine(callback);
+
+    auto order = [](OrderSide side, std::string id) {
+        return std::make_shared<TestOrder>(side, OrderType::LIMIT,
+            OrderTimeInForce::DAY, 100, 10, std::move(id));
+    };
+
+    std::vector<Request> batch{
+        {EngineAction::SELL, order(OrderSide::SELL, "a")},
+        {EngineAction::SELL, order(OrderSide::SELL, "b")},
+        {EngineAction::BUY, order(OrderSide::BUY, "c")},
+    };
+    EXPECT_EQ(engine.Submit(batch), 3);
+    EXPECT_EQ(events, (std::vector<std::string>{"trade a", "flush 3"}));
+
+    events.clear();
+    MpscRing<Request> ring(8);
+    ring.TryPush(Request{EngineAction::CANCEL, nullptr, "b"});
+    ring.TryPush(Request{EngineAction::CANCEL, nullptr, "x"});
+    EXPECT_EQ(engine.Drain(ring, 16), 2);
+    EXPECT_EQ(engine.Drain(ring, 16), 0);
+    EXPECT_EQ(events, (std::vector<std::string>{"cancel b", "flush 2"}));
+}
+
+TEST(Test_MatchingEngine, ExecutionStream) {
+    using namespace pentifica::trd::exch;
+
+    using Stream = ExecutionStream<TestOrder>;
+    using Event = Stream::Event;
+    static_assert(std::is_trivially_copyable_v<Event>);
+
+    Stream stream(16);
+    MatchingEngine<TestOrder, Stream&> engine(stream);
+
+    auto order = [](OrderSide side, int price, std::size_t quantity, std::string id) {
+        return std::make_shared<TestOrder>(side, OrderType::LIMIT,
+            OrderTimeInForce::DAY, price, quantity, std::move(id));
+    };
+
+    auto a{order(OrderSide::SELL, 101, 10, "a")};
+    auto b{order(OrderSide::SELL, 102, 10, "b")};
+    auto c{order(OrderSide::BUY, 102, 15, "c")};
+    auto d{order(OrderSide::BUY, 99, 5, "d")};
+    engine.Sell(a);
+    engine.Sell(b);
+    engine.Buy(c);
+    engine.Buy(d);
+    d->Price(100);
+    engine.Revise(d);
+    engine.Cancel("b");
+
+    std::vector<Event> events;
+    EXPECT_EQ(stream.Drain([&events](std::span<Event const> drained) {
+        events.assign(drained.begin(), drained.end());
+    }), 8);
+    EXPECT_TRUE(stream.Events().empty());
+    EXPECT_EQ(stream.Sequence(), 8);
+
+    ASSERT_EQ(events.size(), 8);
+    for(std::size_t index = 0; index < events.size(); ++index) {
+        EXPECT_EQ(events[index].sequence_, index + 1);
+    }
+    EXPECT_EQ(events[0].type_, ExecutionType::REST);
+    EXPECT_EQ(events[1].type_, ExecutionType::REST);
+
+    EXPECT_EQ(events[2].type_, ExecutionType::TRADE);
+    EXPECT_EQ(events[2].id_.View(), "c");
+    EXPECT_EQ(events[2].resting_id_.View(), "a");
+    EXPECT_EQ(events[2].price_, 101);
+    EXPECT_EQ(events[2].quantity_, 10);
+    EXPECT_EQ(events[2].side_, OrderSide::BUY);
+    EXPECT_EQ(events[3].type_, ExecutionType::TRADE);
+    EXPECT_EQ(events[3].resting_id_.View(), "b");
+    EXPECT_EQ(events[3].price_, 102);
+    EXPECT_EQ(events[3].quantity_, 5);
+
+    EXPECT_EQ(events[4].type_, ExecutionType::REST);
+    EXPECT_EQ(events[4].id_.View(), "d");
+    EXPECT_EQ(events[5].type_, ExecutionType::REST);
+    EXPECT_EQ(events[5].price_, 100);
+    EXPECT_EQ(events[6].type_, ExecutionType::REVISE);
+    EXPECT_EQ(events[6].id_.View(), "d");
+    EXPECT_EQ(events[7].type_, ExecutionType::CANCEL);
+    EXPECT_EQ(events[7].id_.View(), "b");
+    EXPECT_EQ(events[7].quantity_, 5);
+    EXPECT_EQ(events[7].side_, OrderSide::SELL);
+
+    //  an id the stream cannot record in full is rejected, not truncated
+    auto overlong{order(OrderSide::BUY, 99, 5, std::string(order_id_width + 1, 'x'))};
+    engine.Buy(overlong);
+    EXPECT_FALSE(engine.Buy(*overlong));
+    EXPECT_TRUE(stream.Events().empty());
+    EXPECT_EQ(engine.Resting(), 1);
+
+    EXPECT_THROW(FixedId<4>("abcde"), std::length_error);
+    EXPECT_EQ(FixedId<4>::Truncated("abcde").View(), "abcd");
+}
+
+TEST(Test_MatchingEngine, LevelAggregates) {
+    using namespace pentifica::trd::exch;
+
+    auto callback = Overload {
+        [](auto) {}
+    };
+
+    struct TickConfig : EngineConfig {
+        using Ladders = TickLadders<1024>;
+    };
+    using Engine = MatchingEngine<TestOrder, decltype(callback), TickConfig>;
+    using Level = Engine::Level;
+
+    Engine engine(callback);
+    EXPECT_FALSE(engine.BestBid());
+    EXPECT_FALSE(engine.BestAsk());
+
+    auto order = [](OrderSide side, int price, std::size_t quantity, std::string id) {
+        return TestOrder(side, OrderType::LIMIT, OrderTimeInForce::DAY, price, quantity, std::move(id));
+    };
+
+    engine.Buy(order(OrderSide::BUY, 100, 10, "b1"));
+    engine.Buy(order(OrderSide::BUY, 100, 20, "b2"));
+    engine.Buy(order(OrderSide::BUY, 99, 5, "b3"));
+    engine.Buy(order(OrderSide::BUY, 97, 7, "b4"));
+    engine.Sell(order(OrderSide::SELL, 102, 8, "s1"));
+
+    auto bid{engine.BestBid()};
+    ASSERT_TRUE(bid);
+    EXPECT_EQ(bid->price_, 100);
+    EXPECT_EQ(bid->quantity_, 30);
+    EXPECT_EQ(bid->orders_, 2);
+    ASSERT_TRUE(engine.BestAsk());
+    EXPECT_EQ(engine.BestAsk()->quantity_, 8);
+
+    engine.Sell(order(OrderSide::SELL, 100, 15, "s2"));
+    EXPECT_EQ(engine.BestBid()->quantity_, 15);
+    EXPECT_EQ(engine.BestBid()->orders_, 1);
+
+    engine.Cancel("b3");
+    engine.Revise(order(OrderSide::BUY, 97, 3, "b2"));
+
+    std::vector<Level> levels(4);
+    ASSERT_EQ(engine.BidDepth(levels), 1);
+    EXPECT_EQ(levels[0].price_, 97);
+    EXPECT_EQ(levels[0].quantity_, 10);
+    EXPECT_EQ(levels[0].orders_, 2);
+
+    engine.Sell(order(OrderSide::SELL, 104, 1, "s3"));
+    engine.Sell(order(OrderSide::SELL, 103, 2, "s4"));
+    ASSERT_EQ(engine.AskDepth(std::span{levels}.first(2)), 2);
+    EXPECT_EQ(levels[0].price_, 102);
+    EXPECT_EQ(levels[1].price_, 103);
+    EXPECT_EQ(levels[1].quantity_, 2);
+
+    MatchingEngine<TestOrder, decltype(callback)> mapped(callback);
+    mapped.Sell(order(OrderSide::SELL, 101, 4, "m1"));
+    mapped.Sell(order(OrderSide::SELL, 101, 6, "m2"));
+    ASSERT_EQ(mapped.AskDepth(levels), 1);
+    EXPECT_EQ(levels[0].quantity_, 10);
+    EXPECT_EQ(levels[0].orders_, 2);
+}
+
+TEST(Test_MatchingEngine, RevisePriority) {
+    using namespace pentifica::trd::exch;
+
+    std::vector<std::string> revised;
+    auto callback = Overload {
+        [&revised](OnRevise const& info) { revised.push_back(info.order_->Id()); },
+        [](auto) {}
+    };
+    using Engine = MatchingEngine<TestOrder, decltype(callback)>;
+    Engine engine(callback);
+
+    auto order = [](int price, std::size_t quantity, std::string id) {
+        return std::make_shared<TestOrder>(OrderSide::SELL, OrderType::LIMIT,
+            OrderTimeInForce::DAY, price, quantity, std::move(id));
+    };
+    auto queue = [&engine]() {
+        std::vector<std::string> ids;
+        engine.ForEachResting([&ids](TestOrder const& resting) { ids.push_back(resting.Id()); });
+        return ids;
+    };
+
+    for(auto id : {"a", "b", "c"}) {
+        auto resting{order(100, 10, id)};
+        engine.Sell(resting);
+    }
+
+    //  quantity down keeps priority
+    auto a{order(100, 4, "a")};
+    engine.Revise(a);
+    EXPECT_EQ(queue(), (std::vector<std::string>{"a", "b", "c"}));
+    EXPECT_EQ(engine.BestAsk()->quantity_, 24);
+
+    //  quantity up loses priority
+    auto b{order(100, 12, "b")};
+    engine.Revise(b);
+    EXPECT_EQ(queue(), (std::vector<std::string>{"a", "c", "b"}));
+    EXPECT_EQ(engine.BestAsk()->quantity_, 26);
+
+    //  price change loses priority
+    auto c{order(101, 10, "c")};
+    engine.Revise(c);
+    EXPECT_EQ(queue(), (std::vector<std::string>{"a", "b", "c"}));
+    EXPECT_EQ(engine.BestAsk()->quantity_, 16);
+    EXPECT_EQ(revised, (std::vector<std::string>{"a", "b", "c"}));
+
+    //  in place amendments are seen by fills
+    std::vector<std::size_t> fills;
+    struct PooledConfig : EngineConfig {
+        using Orders = PooledOrders<16>;
+        using Keys = FixedIdKeys<16>;
+    };
+    auto pooled_callback = Overload {
+        [&fills](EngineOnTrade<PoolOrder, PoolOrder*> const& info) { fills.push_back(info.quantity_); },
+        [](auto) {}
+    };
+    auto pool_order = [](int price, std::size_t quantity, std::string_view id) {
+        return PoolOrder(OrderSide::SELL, OrderType::LIMIT, OrderTimeInForce::DAY, price, quantity, id);
+    };
+    MatchingEngine<PoolOrder, decltype(pooled_callback), PooledConfig> pooled(pooled_callback);
+    pooled.Sell(pool_order(100, 10, "x"));
+    pooled.Sell(pool_order(100, 10, "y"));
+    EXPECT_TRUE(pooled.Revise(pool_order(100, 3, "x")));
+    pooled.Buy(PoolOrder(OrderSide::BUY, OrderType::LIMIT, OrderTimeInForce::IOC, 100, 20, "z"));
+    EXPECT_EQ(fills, (std::vector<std::size_t>{3, 10}));
+    EXPECT_EQ(pooled.Resting(), 0);
+}
+
+TEST(Test_MatchingEngine, AuctionUncross) {
+    using namespace pentifica::trd::exch;
+
+    struct Fill {
+        std::string buy_;
+        std::string sell_;
+        std::size_t quantity_;
+        bool operator==(Fill const&) const = default;
+    };
+    std::vector<Fill> fills;
+    std::vector<std::string> rejects;
+    auto callback = Overload {
+        [&fills](OnTrade const& info) {
+            fills.push_back({info.new_order_->Id(), info.existing_order_->Id(), info.quantity_});
+        },
+        [&rejects](EngineOnReject<TestOrder> const& info) {
+            EXPECT_EQ(info.reason_, RejectReason::AUCTION);
+            rejects.push_back(info.order_.Id());
+        },
+        [](auto) {}
+    };
+    MatchingEngine<TestOrder, decltype(callback)> engine(callback);
+
+    auto order = [](OrderSide side, int price, std::size_t quantity, std::string id) {
+        return std::make_shared<TestOrder>(side, OrderType::LIMIT,
+            OrderTimeInForce::DAY, price, quantity, std::move(id));
+    };
+
+    engine.BeginAuction();
+    EXPECT_TRUE(engine.InAuction());
+    for(auto const& spec : std::vector<OrderSpec>{
+        {"b1", 103, 10, OrderSide::BUY},
+        {"b2", 102, 20, OrderSide::BUY},
+        {"b3", 100, 30, OrderSide::BUY},
+        {"s1", 99, 15, OrderSide::SELL},
+        {"s2", 101, 10, OrderSide::SELL},
+        {"s3", 102, 25, OrderSide::SELL},
+    }) {
+        auto resting{order(spec.side_, spec.price_, spec.quantity_, spec.id_)};
+        if(spec.side_ == OrderSide::BUY)    engine.Buy(resting);
+        else                                engine.Sell(resting);
+    }
+    auto market{std::make_shared<TestOrder>(OrderSide::BUY, OrderType::MARKET,
+        OrderTimeInForce::IOC, 0, 5, "m")};
+    engine.Buy(market);
+    auto fok{order(OrderSide::SELL, 99, 5, "f")};
+    fok->TIF(OrderTimeInForce::FOK);
+    engine.Sell(fok);
+    //  a revision that cannot rest leaves the order as it was
+    auto ioc{order(OrderSide::BUY, 103, 10, "b1")};
+    ioc->TIF(OrderTimeInForce::IOC);
+    engine.Revise(ioc);
+    EXPECT_EQ(rejects, (std::vector<std::string>{"m", "f", "b1"}));
+    EXPECT_TRUE(fills.empty());
+    EXPECT_EQ(engine.Resting(), 6);
+
+    //  at 102: bids 30, offers 50 -> 30; at 101: bids 30, offers 25 -> 25
+    auto const result{engine.Uncross()};
+    EXPECT_FALSE(engine.InAuction());
+    EXPECT_EQ(result.price_, 102);
+    EXPECT_EQ(result.quantity_, 30);
+    EXPECT_EQ(fills, (std::vector<Fill>{{"b1", "s1", 10}, {"b2", "s1", 5}, {"b2", "s2", 10}, {"b2", "s3", 5}}));
+
+    ASSERT_TRUE(engine.BestBid());
+    EXPECT_EQ(engine.BestBid()->price_, 100);
+    ASSERT_TRUE(engine.BestAsk());
+    EXPECT_EQ(engine.BestAsk()->price_, 102);
+    EXPECT_EQ(engine.BestAsk()->quantity_, 20);
+
+    EXPECT_EQ(engine.Uncross().quantity_, 0);
+
+    struct TickConfig : EngineConfig {
+        using Ladders = TickLadders<256>;
+        using Orders = PooledOrders<64>;
+        using Keys = FixedIdKeys<64>;
+    };
+    auto pool_order = [](OrderSide side, int price, std::size_t quantity, std::string_view id) {
+        return PoolOrder(side, OrderType::LIMIT, OrderTimeInForce::DAY, price, quantity, id);
+    };
+    MatchingEngine<PoolOrder, decltype(callback), TickConfig> ticked(callback);
+    ticked.BeginAuction();
+    EXPECT_FALSE(ticked.Buy(PoolOrder(OrderSide::BUY, OrderType::MARKET, OrderTimeInForce::IOC, 0, 5, "m4")));
+    ticked.Sell(pool_order(OrderSide::SELL, 100, 5, "s4"));
+    ticked.Buy(pool_order(OrderSide::BUY, 101, 8, "b4"));
+    auto const crossed{ticked.Uncross()};
+    EXPECT_EQ(crossed.price_, 101);
+    EXPECT_EQ(crossed.quantity_, 5);
+    EXPECT_EQ(ticked.BestBid()->quantity_, 3);
+    EXPECT_FALSE(ticked.BestAsk());
+
+    //  every level the uncross changes is reported, including one whose
+    //  front order filled while others remain
+    std::vector<EngineOnLevel<int>> levels;
+    auto level_callback = Overload {
+        [&levels](EngineOnLevel<int> const& info) { levels.push_back(info); },
+        [](auto) {}
+    };
+    MatchingEngine<TestOrder, decltype(level_callback)> leveled(level_callback);
+    leveled.BeginAuction();
+    leveled.Buy(*order(OrderSide::BUY, 100, 5, "b5"));
+    leveled.Buy(*order(OrderSide::BUY, 100, 5, "b6"));
+    leveled.Sell(*order(OrderSide::SELL, 100, 5, "s5"));
+    levels.clear();
+    EXPECT_EQ(leveled.Uncross().quantity_, 5);
+    ASSERT_EQ(levels.size(), 2);
+    EXPECT_EQ(levels[0].side_, OrderSide::BUY);
+    EXPECT_EQ(levels[0].level_, (BookLevel<int>{100, 5, 1}));
+    EXPECT_EQ(levels[1].side_, OrderSide::SELL);
+    EXPECT_EQ(levels[1].level_, (BookLevel<int>{100, 0, 0}));
+
+    //  an iceberg's reserve counts towards the auction
+    fills.clear();
+    MatchingEngine<TestOrder, decltype(callback)> iceberg(callback);
+    iceberg.BeginAuction();
+    auto hidden{order(OrderSide::SELL, 100, 20, "s6")};
+    hidden->MaxShow(5);
+    iceberg.Sell(hidden);
+    iceberg.Sell(*order(OrderSide::SELL, 100, 5, "s7"));
+    iceberg.Buy(*order(OrderSide::BUY, 100, 15, "b7"));
+    EXPECT_EQ(iceberg.Uncross().quantity_, 15);
+    EXPECT_EQ(fills, (std::vector<Fill>{{"b7", "s6", 5}, {"b7", "s7", 5}, {"b7", "s6", 5}}));
+    EXPECT_EQ(iceberg.BestAsk()->quantity_, 5);
+    EXPECT_EQ(iceberg.Resting(), 1);
+}
+
+TEST(Test_MatchingEngine, StopOrders) {
+    using namespace pentifica::trd::exch;
+
+    std::vector<std::string> events;
+    auto callback = Overload {
+        [&events](OnTrade const& info) {
+            events.push_back(info.new_order_->Id() + "x" + info.existing_order_->Id());
+        },
+        [&events](EngineOnTrigger<TestOrder> const& info) { events.push_back("stop " + info.order_->Id()); },
+        [&events](EngineOnReject<TestOrder> const& info) {
+            EXPECT_EQ(info.reason_, RejectReason::PRICE_OUT_OF_RANGE);
+            events.push_back("reject " + info.order_.Id());
+        },
+        [](auto) {}
+    };
+    MatchingEngine<TestOrder, decltype(callback)> engine(callback);
+
+    auto limit = [](OrderSide side, int price, std::size_t quantity, std::string id) {
+        return std::make_shared<TestOrder>(side, OrderType::LIMIT,
+            OrderTimeInForce::DAY, price, quantity, std::move(id));
+    };
+    auto stop = [](OrderSide side, OrderType type, int stop_price, int price, std::string id) {
+        auto order{std::make_shared<TestOrder>(side, type, OrderTimeInForce::DAY, price, 5, std::move(id))};
+        order->StopPrice(stop_price);
+        return order;
+    };
+
+    for(auto [price, id] : std::vector<std::pair<int, std::string>>{{101, "a1"}, {102, "a2"}, {103, "a3"}, {105, "a4"}}) {
+        auto ask{limit(OrderSide::SELL, price, 5, id)};
+        engine.Sell(ask);
+    }
+    //  no trade yet, so no stop can trigger
+    auto s1{stop(OrderSide::BUY, OrderType::STOP, 101, 0, "s1")};
+    auto s2{stop(OrderSide::BUY, OrderType::STOP_LIMIT, 102, 102, "s2")};
+    auto s3{stop(OrderSide::BUY, OrderType::STOP, 110, 0, "s3")};
+    auto s4{stop(OrderSide::SELL, OrderType::STOP, 90, 0, "s4")};
+    engine.Buy(s3);
+    engine.Buy(s2);
+    engine.Buy(s1);
+    engine.Sell(s4);
+    EXPECT_TRUE(events.empty());
+    EXPECT_EQ(engine.Resting(), 8);
+
+    //  trade at 101 releases s1, whose trade at 102 releases s2, which rests
+    auto taker{limit(OrderSide::BUY, 101, 5, "t")};
+    engine.Buy(taker);
+    EXPECT_EQ(events, (std::vector<std::string>{"txa1", "stop s1", "s1xa2", "stop s2"}));
+    EXPECT_EQ(engine.LastPrice(), 102);
+    EXPECT_EQ(s1->Type(), OrderType::MARKET);
+    EXPECT_EQ(s2->Type(), OrderType::LIMIT);
+    ASSERT_TRUE(engine.BestBid());
+    EXPECT_EQ(engine.BestBid()->price_, 102);
+    EXPECT_EQ(engine.BestBid()->quantity_, 5);
+
+    //  pending stops can be cancelled
+    engine.Cancel("s3");
+    engine.Cancel("s4");
+    EXPECT_EQ(engine.Resting(), 3);
+
+    //  a stop arriving beyond its trigger is released at once
+    events.clear();
+    auto s5{stop(OrderSide::BUY, OrderType::STOP, 100, 0, "s5")};
+    engine.Buy(s5);
+    EXPECT_EQ(events, (std::vector<std::string>{"stop s5", "s5xa3"}));
+
+    //  a limit revised into a stop leaves the live book, and cancelling it
+    //  leaves the stops pending at its price alone
+    auto s6{stop(OrderSide::BUY, OrderType::STOP, 104, 0, "s6")};
+    engine.Buy(s6);
+    auto b1{limit(OrderSide::BUY, 104, 5, "b1")};
+    engine.Buy(b1);
+    auto revised{stop(OrderSide::BUY, OrderType::STOP_LIMIT, 120, 104, "b1")};
+    engine.Revise(revised);
+    EXPECT_EQ(engine.BestBid()->price_, 102);
+    engine.Cancel("b1");
+    EXPECT_EQ(engine.BestBid()->price_, 102);
+    std::size_t visited{};
+    engine.ForEachResting([&visited](TestOrder const&) { ++visited; });
+    EXPECT_EQ(visited, engine.Resting());
+
+    events.clear();
+    auto lift{limit(OrderSide::BUY, 105, 5, "l")};
+    engine.Buy(lift);
+    EXPECT_EQ(events, (std::vector<std::string>{"lxa4", "stop s6"}));
+
+    //  a stop limit whose price has left the tick window is rejected
+    struct TickConfig : EngineConfig {
+        using Ladders = TickLadders<64>;
+    };
+    MatchingEngine<TestOrder, decltype(callback), TickConfig> ticked(callback);
+    ticked.Sell(*limit(OrderSide::SELL, 100, 5, "a1"));
+    ticked.Buy(*stop(OrderSide::BUY, OrderType::STOP_LIMIT, 100, 200, "s1"));
+    ticked.Buy(*limit(OrderSide::BUY, 20, 1, "b1"));
+    events.clear();
+    EXPECT_TRUE(ticked.Buy(TestOrder(OrderSide::BUY, OrderType::LIMIT, OrderTimeInForce::IOC, 100, 1, "t")));
+    EXPECT_EQ(ticked.LastPrice(), 100);
+    EXPECT_EQ(events, (std::vector<std::string>{"txa1", "reject s1"}));
+    EXPECT_EQ(ticked.Resting(), 2);
+}
+
+TEST(Test_MatchingEngine, IcebergOrders) {
+    using namespace pentifica::trd::exch;
+
+    std::vector<std::pair<std::string, std::size_t>> fills;
+    auto callback = Overload {
+        [&fills](OnTrade const& info) { fills.emplace_back(info.existing_order_->Id(), info.quantity_); },
+        [](auto) {}
+    };
+    MatchingEngine<TestOrder, decltype(callback)> engine(callback);
+
+    auto order = [](OrderSide side, std::size_t quantity, std::string id, std::size_t max_show = 0) {
+        auto result{std::make_shared<TestOrder>(side, OrderType::LIMIT,
+            OrderTimeInForce::DAY, 100, quantity, std::move(id))};
+        result->MaxShow(max_show);
+        return result;
+    };
+
+    auto ice{order(OrderSide::SELL, 25, "ice", 10)};
+    auto plain{order(OrderSide::SELL, 5, "plain")};
+    engine.Sell(ice);
+    engine.Sell(plain);
+    EXPECT_EQ(engine.BestAsk()->quantity_, 15);
+    EXPECT_EQ(engine.BestAsk()->orders_, 2);
+
+    //  the first slice fills, the refill goes behind "plain"
+    auto taker{order(OrderSide::BUY, 12, "t1")};
+    engine.Buy(taker);
+    EXPECT_EQ(fills, (std::vector<std::pair<std::string, std::size_t>>{{"ice", 10}, {"plain", 2}}));
+    EXPECT_EQ(ice->Quantity(), 15);
+    EXPECT_EQ(engine.BestAsk()->quantity_, 13);
+
+    fills.clear();
+    auto sweep{order(OrderSide::BUY, 40, "t2")};
+    engine.Buy(sweep);
+    EXPECT_EQ(fills, (std::vector<std::pair<std::string, std::size_t>>{{"plain", 3}, {"ice", 10}, {"ice", 5}}));
+    EXPECT_EQ(ice->Quantity(), 0);
+    EXPECT_FALSE(engine.BestAsk());
+    EXPECT_EQ(engine.BestBid()->quantity_, 22);
+
+    //  reducing an iceberg's reserve keeps its place
+    auto resting{order(OrderSide::BUY, 30, "ice2", 4)};
+    engine.Buy(resting);
+    EXPECT_EQ(engine.BestBid()->quantity_, 26);
+    auto reduced{order(OrderSide::BUY, 20, "ice2", 4)};
+    engine.Revise(reduced);
+    EXPECT_EQ(engine.BestBid()->quantity_, 26);
+    std::vector<std::string> queue;
+    engine.ForEachResting([&queue](TestOrder const& resting) { queue.push_back(resting.Id()); });
+    EXPECT_EQ(queue, (std::vector<std::string>{"t2", "ice2"}));
+}
+
+TEST(Test_MatchingEngine, FillOrKillAndMinQty) {
+    using namespace pentifica::trd::exch;
+
+    std::vector<std::string> events;
+    auto callback = Overload {
+        [&events](EngineOnTrade<PoolOrder, PoolOrder*> const& info) {
+            events.push_back("trade " + std::to_string(info.quantity_));
+        },
+        [&events](EngineOnReject<PoolOrder> const& info) {
+            EXPECT_EQ(info.reason_, RejectReason::INSUFFICIENT_LIQUIDITY);
+            events.push_back("kill " + std::string(info.order_.Id()));
+        },
+        [](auto) {}
+    };
+    struct PooledConfig : EngineConfig {
+        using Orders = PooledOrders<16>;
+        using Keys = FixedIdKeys<16>;
+    };
+    MatchingEngine<PoolOrder, decltype(callback), PooledConfig> engine(callback);
+
+    auto order = [](OrderSide side, OrderTimeInForce tif, int price, std::size_t quantity,
+        std::string id, std::size_t min_qty = 0) {
+        PoolOrder result(side, OrderType::LIMIT, tif, price, quantity, std::move(id));
+        result.MinQty(min_qty);
+        return result;
+    };
+
+    engine.Sell(order(OrderSide::SELL, OrderTimeInForce::DAY, 100, 5, "a1"));
+    engine.Sell(order(OrderSide::SELL, OrderTimeInForce::DAY, 101, 5, "a2"));
+    engine.Sell(order(OrderSide::SELL, OrderTimeInForce::DAY, 103, 5, "a3"));
+
+    //  only 10 crosses at 101
+    EXPECT_FALSE(engine.Buy(order(OrderSide::BUY, OrderTimeInForce::FOK, 101, 12, "f1")));
+    EXPECT_FALSE(engine.Buy(order(OrderSide::BUY, OrderTimeInForce::DAY, 101, 20, "m1", 11)));
+    EXPECT_EQ(events, (std::vector<std::string>{"kill f1", "kill m1"}));
+    EXPECT_EQ(engine.BestAsk()->quantity_, 5);
+    EXPECT_EQ(engine.Resting(), 3);
+
+    events.clear();
+    EXPECT_TRUE(engine.Buy(order(OrderSide::BUY, OrderTimeInForce::FOK, 101, 7, "f2")));
+    EXPECT_EQ(events, (std::vector<std::string>{"trade 5", "trade 2"}));
+    EXPECT_FALSE(engine.BestBid());
+
+    //  a minimum quantity order rests what it does not fill
+    events.clear();
+    EXPECT_TRUE(engine.Buy(order(OrderSide::BUY, OrderTimeInForce::DAY, 101, 10, "m2", 3)));
+    EXPECT_EQ(events, (std::vector<std::string>{"trade 3"}));
+    ASSERT_TRUE(engine.BestBid());
+    EXPECT_EQ(engine.BestBid()->quantity_, 7);
+
+    //  the minimum applies on arrival only: a re-queued remainder rests
+    events.clear();
+    EXPECT_TRUE(engine.Revise(order(OrderSide::BUY, OrderTimeInForce::DAY, 100, 8, "m2", 3)));
+    EXPECT_TRUE(events.empty());
+    ASSERT_TRUE(engine.BestBid());
+    EXPECT_EQ(engine.BestBid()->price_, 100);
+    EXPECT_EQ(engine.BestBid()->quantity_, 8);
+
+    //  a revision that raises the minimum is screened again
+    events.clear();
+    EXPECT_TRUE(engine.Revise(order(OrderSide::BUY, OrderTimeInForce::DAY, 103, 8, "m2", 8)));
+    EXPECT_EQ(events, (std::vector<std::string>{"kill m2"}));
+    EXPECT_FALSE(engine.BestBid());
+    EXPECT_EQ(engine.BestAsk()->quantity_, 5);
+    EXPECT_EQ(engine.Resting(), 1);
+}
+
+TEST(Test_MatchingEngine, OrderExpiry) {
+    using namespace pentifica::trd::exch;
+
+    std::vector<std::string> cancelled;
+    std::vector<BookLevel<int>> levels;
+    auto callback = Overload {
+        [&cancelled](EngineOnCancel<PoolOrder, PoolOrder*> const& info) {
+            cancelled.emplace_back(info.order_->Id());
+        },
+        [&levels](EngineOnLevel<int> const& info) { levels.push_back(info.level_); },
+        [](auto) {}
+    };
+    struct PooledConfig : EngineConfig {
+        using Orders = PooledOrders<16>;
+        using Keys = FixedIdKeys<16>;
+    };
+    MatchingEngine<PoolOrder, decltype(callback), PooledConfig> engine(callback);
+
+    PoolOrder::TimePoint const open{std::chrono::hours{1000}};
+    auto order = [open](OrderSide side, OrderTimeInForce tif, int price, std::string id,
+        std::chrono::milliseconds expiry = {}) {
+        PoolOrder result(side, OrderType::LIMIT, tif, price, 10, std::move(id), open);
+        result.ExpireTime(open + expiry);
+        return result;
+    };
+    using std::chrono::milliseconds;
+
+    engine.Expire(open);
+    engine.Buy(order(OrderSide::BUY, OrderTimeInForce::GTD, 100, "g1", milliseconds{50}));
+    engine.Buy(order(OrderSide::BUY, OrderTimeInForce::GTD, 100, "g2", milliseconds{5000}));
+    engine.Buy(order(OrderSide::BUY, OrderTimeInForce::DAY, 100, "d1"));
+    engine.Buy(order(OrderSide::BUY, OrderTimeInForce::DAY, 99, "d2"));
+    engine.Sell(order(OrderSide::SELL, OrderTimeInForce::GTC, 105, "c1"));
+    engine.Sell(order(OrderSide::SELL, OrderTimeInForce::DAY, 106, "d3"));
+
+    EXPECT_EQ(engine.Expire(open + milliseconds{49}), 0);
+    EXPECT_EQ(engine.Expire(open + milliseconds{50}), 1);
+    EXPECT_EQ(cancelled, (std::vector<std::string>{"g1"}));
+
+    //  revising the expiry moves the order in the wheel without losing its place
+    auto later{order(OrderSide::BUY, OrderTimeInForce::GTD, 100, "g2", milliseconds{20000})};
+    EXPECT_TRUE(engine.Revise(later));
+    EXPECT_EQ(engine.Expire(open + milliseconds{10000}), 0);
+    EXPECT_EQ(engine.Resting(), 5);
+
+    //  a filled order leaves the wheel
+    engine.Sell(PoolOrder(OrderSide::SELL, OrderType::MARKET, OrderTimeInForce::IOC, 0, 10, "hit"));
+    EXPECT_EQ(engine.Expire(open + milliseconds{30000}), 0);
+
+    cancelled.clear();
+    levels.clear();
+    EXPECT_EQ(engine.PurgeDay(), 3);
+    EXPECT_EQ(cancelled, (std::vector<std::string>{"d1", "d2", "d3"}));
+    EXPECT_EQ(levels, (std::vector<BookLevel<int>>{{100, 0, 0}, {99, 0, 0}, {106, 0, 0}}));
+    EXPECT_EQ(engine.Resting(), 1);
+    EXPECT_FALSE(engine.BestBid());
+    EXPECT_EQ(engine.BestAsk()->price_, 105);
+}
+
+TEST(Test_MatchingEngine, MassCancel) {
+    using namespace pentifica::trd::exch;
+
+    std::vector<std::string> cancelled;
+    std::vector<BookLevel<int>> levels;
+    auto callback = Overload {
+        [&cancelled](EngineOnCancel<PoolOrder, PoolOrder*> const& info) {
+            cancelled.emplace_back(info.order_->Id());
+        },
+        [&levels](EngineOnLevel<int> const& info) { levels.push_back(info.level_); },
+        [](auto) {}
+    };
+    struct PooledConfig : EngineConfig {
+        using Orders = PooledOrders<16>;
+        using Keys = FixedIdKeys<16>;
+    };
+    using Engine = MatchingEngine<PoolOrder, decltype(callback), PooledConfig>;
+    Engine engine(callback);
+
+    auto order = [](OrderSide side, int price, std::string id, std::string account, std::string session) {
+        PoolOrder result(side, OrderType::LIMIT, OrderTimeInForce::GTC, price, 10, std::move(id));
+        result.Account(std::move(account));
+        result.Session(std::move(session));
+        return result;
+    };
+    engine.Buy(order(OrderSide::BUY, 100, "b1", "MM1", "S1"));
+    engine.Buy(order(OrderSide::BUY, 100, "b2", "MM2", "S2"));
+    engine.Buy(order(OrderSide::BUY, 100, "b3", "MM1", "S1"));
+    engine.Buy(order(OrderSide::BUY, 99, "b4", "MM1", "S2"));
+    engine.Sell(order(OrderSide::SELL, 105, "s1", "MM1", "S1"));
+    engine.Sell(order(OrderSide::SELL, 106, "s2", "", ""));
+    auto stop{order(OrderSide::SELL, 90, "t1", "MM1", "S2")};
+    stop.Type(OrderType::STOP);
+    stop.StopPrice(95);
+    engine.Sell(stop);
+
+    //  an order moved to another account by a revision is listed under it
+    EXPECT_TRUE(engine.Revise(order(OrderSide::BUY, 100, "b3", "MM2", "S1")));
+    EXPECT_EQ(engine.Resting(), 7);
+
+    cancelled.clear();
+    levels.clear();
+    EXPECT_EQ(engine.CancelAccount("MM1"), 4);
+    EXPECT_EQ(cancelled, (std::vector<std::string>{"b1", "b4", "s1", "t1"}));
+    //  each level reported once
+    EXPECT_EQ(levels.size(), 3);
+    EXPECT_EQ(engine.BestBid(), (BookLevel<int>{100, 20, 2}));
+    EXPECT_EQ(engine.BestAsk()->price_, 106);
+    EXPECT_EQ(engine.CancelAccount("MM1"), 0);
+    EXPECT_EQ(engine.CancelAccount("none"), 0);
+
+    cancelled.clear();
+    Engine::Request request{EngineAction::CANCEL_SESSION, order(OrderSide::UNKNOWN, 0, "", "", "S2")};
+    engine.Apply(request);
+    EXPECT_EQ(cancelled, (std::vector<std::string>{"b2"}));
+    EXPECT_EQ(engine.Resting(), 2);
+    EXPECT_EQ(engine.CancelSession("S1"), 1);
+    EXPECT_EQ(engine.Resting(), 1);
+}
+
+namespace {
+    /// @brief A pooled engine configuration sharing fills by Policy
+    template<typename Policy>
+    struct PolicyConfig : EngineConfig {
+        using Orders = PooledOrders<64>;
+        using Keys = FixedIdKeys<64>;
+        using Matching = Policy;
+    };
+    /// @brief Runs a sell of quantity into bids of the given sizes at one
+    ///        price, returning what each bid was filled for
+    template<typename Policy>
+    std::vector<std::size_t> Allocation(std::vector<std::size_t> const& bids, std::size_t quantity,
+        std::function<void(Policy&)> const& configure = {}) {
+        std::unordered_map<std::string, std::size_t> filled;
+        auto callback = Overload {
+            [&filled](EngineOnTrade<PoolOrder, PoolOrder*> const& info) {
+                filled[std::string(info.existing_order_->Id())] += info.quantity_;
+            },
+            [](auto) {}
+        };
+        MatchingEngine<PoolOrder, decltype(callback), PolicyConfig<Policy>> engine(callback);
+        if(configure) configure(engine.MatchingPolicy());
+
+        for(std::size_t index = 0; index < bids.size(); ++index) {
+            PoolOrder bid(OrderSide::BUY, OrderType::LIMIT, OrderTimeInForce::DAY, 100, bids[index],
+                "b" + std::to_string(index));
+            bid.Account(index == 2 ? "LMM" : "");
+            engine.Buy(bid);
+        }
+        engine.Sell(PoolOrder(OrderSide::SELL, OrderType::LIMIT, OrderTimeInForce::IOC, 100, quantity, "s"));
+
+        std::vector<std::size_t> result;
+        for(std::size_t index = 0; index < bids.size(); ++index) result.push_back(filled["b" + std::to_string(index)]);
+        return result;
+    }
+}
+
+TEST(Test_MatchingEngine, MatchingPolicies) {
+    using namespace pentifica::trd::exch;
+    using Fills = std::vector<std::size_t>;
+
+    EXPECT_EQ(Allocation<FifoMatching>({10, 30, 60}, 50), (Fills{10, 30, 10}));
+
+    EXPECT_EQ(Allocation<ProRataMatching>({10, 30, 60}, 50), (Fills{5, 15, 30}));
+    //  the one left over by rounding down goes in time priority
+    EXPECT_EQ(Allocation<ProRataMatching>({10, 30, 60}, 45), (Fills{5, 13, 27}));
+    EXPECT_EQ(Allocation<ProRataMatching>({10, 30, 60}, 100), (Fills{10, 30, 60}));
+    EXPECT_EQ(Allocation<ProRataMatching>({10, 30, 60}, 1), (Fills{1, 0, 0}));
+
+    //  the first bid set the best price
+    EXPECT_EQ(Allocation<TopOrderMatching<>>({10, 30, 60}, 50), (Fills{10, 14, 26}));
+    EXPECT_EQ(Allocation<TopOrderMatching<>>({10, 30, 60}, 4), (Fills{4, 0, 0}));
+
+    //  the market maker's 40% of 50 comes first
+    using Lmm = LmmMatching<40>;
+    auto designate = [](auto& policy) { policy.AddMaker("LMM"); };
+    EXPECT_EQ(Allocation<Lmm>({10, 30, 60}, 50, designate), (Fills{4, 11, 35}));
+    EXPECT_EQ(Allocation<Lmm>({10, 30, 60}, 50), Allocation<ProRataMatching>({10, 30, 60}, 50));
+    EXPECT_EQ((Allocation<LmmMatching<40, FifoMatching>>({10, 30, 60}, 50, designate)), (Fills{10, 20, 20}));
+}
+
+TEST(Test_MatchingEngine, TickPriceOrders) {
+    using namespace pentifica::trd::exch;
+    using Price = pentifica::trd::TickPrice<2>;
+    using CentOrder = CompactOrder<Price>;
+
+    std::vector<std::pair<Price, std::size_t>> trades;
+    std::vector<RejectReason> rejects;
+    auto callback = Overload {
+        [&trades](EngineOnTrade<CentOrder, CentOrder*> const& info) {
+            trades.emplace_back(info.existing_order_->Price(), info.quantity_);
+        },
+        [&rejects](EngineOnReject<CentOrder> const& info) { rejects.push_back(info.reason_); },
+        [](auto) {}
+    };
+    struct Config : EngineConfig {
+        using Ladders = TickLadders<1024>;
+        using Orders = PooledOrders<16>;
+        using Keys = FixedIdKeys<16>;
+    };
+    MatchingEngine<CentOrder, decltype(callback), Config> engine(callback);
+
+    engine.Sell(CentOrder(OrderSide::SELL, OrderType::LIMIT, OrderTimeInForce::DAY, Price{10001}, 5, "a1"));
+    engine.Sell(CentOrder(OrderSide::SELL, OrderType::LIMIT, OrderTimeInForce::DAY, Price{10000}, 5, "a2"));
+    engine.Buy(CentOrder(OrderSide::BUY, OrderType::LIMIT, OrderTimeInForce::DAY, Price{9990}, 5, "b1"));
+    EXPECT_FALSE(engine.Buy(CentOrder(OrderSide::BUY, OrderType::LIMIT, OrderTimeInForce::DAY,
+        Price{20000}, 5, "far")));
+    EXPECT_EQ(rejects, std::vector<RejectReason>{RejectReason::PRICE_OUT_OF_RANGE});
+
+    engine.Buy(CentOrder(OrderSide::BUY, OrderType::LIMIT, OrderTimeInForce::IOC, Price{10001}, 7, "b2"));
+    EXPECT_EQ(trades, (std::vector<std::pair<Price, std::size_t>>{{Price{10000}, 5}, {Price{10001}, 2}}));
+    EXPECT_EQ(engine.BestAsk()->price_, Price{10001});
+    EXPECT_EQ(engine.BestBid()->price_, Price{9990});
+}
+
+TEST(Test_MatchingEngine, CompactOrders) {
+    using namespace pentifica::trd::exch;
+    using Compact = CompactOrder<int>;
+
+    std::vector<std::pair<std::string, std::size_t>> trades;
+    std::vector<std::string> cancelled;
+    auto callback = Overload {
+        [&trades](EngineOnTrade<Compact, Compact*> const& info) {
+            trades.emplace_back(info.existing_order_->Id(), info.quantity_);
+        },
+        [&cancelled](EngineOnCancel<Compact, Compact*> const& info) {
+            cancelled.emplace_back(info.order_->Id());
+        },
+        [](auto) {}
+    };
+    struct Config : EngineConfig {
+        using Orders = PooledOrders<16>;
+        using Keys = FixedIdKeys<16>;
+    };
+    using Engine = MatchingEngine<Compact, decltype(callback), Config>;
+    Engine engine(callback);
+
+    auto order = [](OrderSide side, int price, std::size_t quantity, std::string_view id,
+        std::string_view account = {}) {
+        Compact result(side, OrderType::LIMIT, OrderTimeInForce::GTC, price, quantity, id);
+        result.Account(account);
+        return result;
+    };
+    engine.Sell(order(OrderSide::SELL, 101, 10, "ask-0000000000000001", "MM1"));
+    engine.Sell(order(OrderSide::SELL, 101, 10, "ask-0000000000000002"));
+    engine.Sell(order(OrderSide::SELL, 102, 10, "ask-0000000000000003", "MM1"));
+    EXPECT_EQ(engine.Resting(), 3);
+
+    engine.Buy(order(OrderSide::BUY, 101, 15, "bid-0000000000000001"));
+    EXPECT_EQ(trades, (std::vector<std::pair<std::string, std::size_t>>{
+        {"ask-0000000000000001", 10}, {"ask-0000000000000002", 5}}));
+
+    engine.Cancel(Engine::KeyType("ask-0000000000000002"));
+    EXPECT_EQ(cancelled, (std::vector<std::string>{"ask-0000000000000002"}));
+    EXPECT_EQ(engine.CancelAccount("MM1"), 1);
+    EXPECT_EQ(engine.Resting(), 0);
+}
+
+TEST(Test_MatchingEngine, OverlongIdRejected) {
+    using namespace pentifica::trd::exch;
+
+    std::size_t trades{};
+    std::vector<std::pair<std::string, RejectReason>> rejects;
+    auto callback = Overload {
+        [&trades](OnTrade const&) { ++trades; },
+        [&rejects](EngineOnReject<TestOrder> const& info) {
+            rejects.emplace_back(info.order_.Id(), info.reason_);
+        },
+        [](auto) {}
+    };
+    struct Config : EngineConfig {
+        using Keys = FixedIdKeys<16>;
+    };
+    MatchingEngine<TestOrder, decltype(callback), Config> engine(callback);
+
+    std::string const overlong(order_id_width + 1, 'x');
+    engine.Sell(TestOrder(OrderSide::SELL, OrderType::LIMIT, OrderTimeInForce::GTC, 100, 10, "ask"));
+
+    //  rejected before matching, by copy and by shared order alike
+    EXPECT_FALSE(engine.Buy(TestOrder(OrderSide::BUY, OrderType::LIMIT, OrderTimeInForce::GTC, 100, 15, overlong)));
+    auto shared{std::make_shared<TestOrder>(OrderSide::BUY, OrderType::LIMIT, OrderTimeInForce::GTC, 100, 15,
+        overlong)};
+    engine.Buy(shared);
+    EXPECT_FALSE(engine.Restore(TestOrder(OrderSide::BUY, OrderType::LIMIT, OrderTimeInForce::GTC, 99, 5,
+        overlong)));
+    EXPECT_FALSE(engine.Revise(TestOrder(OrderSide::BUY, OrderType::LIMIT, OrderTimeInForce::GTC, 99, 5,
+        overlong)));
+
+    EXPECT_EQ(trades, 0);
+    EXPECT_EQ(rejects, (std::vector<std::pair<std::string, RejectReason>>(3, {overlong, RejectReason::INVALID_ID})));
+    EXPECT_EQ(engine.Resting(), 1);
+    EXPECT_EQ(shared->Quantity(), 15);
+}
+
+TEST(Test_MatchingEngine, DuplicateIdRejected) {
+    using namespace pentifica::trd::exch;
+
+    std::size_t trades{};
+    std::vector<std::string> rejects;
+    auto callback = Overload {
+        [&trades](OnTrade const&) { ++trades; },
+        [&rejects](EngineOnReject<TestOrder> const& info) {
+            EXPECT_EQ(info.reason_, RejectReason::DUPLICATE_ID);
+            rejects.push_back(info.order_.Id());
+        },
+        [](auto) {}
+    };
+    MatchingEngine<TestOrder, decltype(callback)> engine(callback);
+
+    auto order = [](OrderSide side, int price, std::string id) {
+        return TestOrder(side, OrderType::LIMIT, OrderTimeInForce::DAY, price, 10, std::move(id));
+    };
+    EXPECT_TRUE(engine.Sell(order(OrderSide::SELL, 100, "a")));
+
+    //  a live order keeps its place; the duplicate neither rests nor trades
+    EXPECT_FALSE(engine.Sell(order(OrderSide::SELL, 101, "a")));
+    auto shared{std::make_shared<TestOrder>(order(OrderSide::BUY, 100, "a"))};
+    engine.Buy(shared);
+    EXPECT_FALSE(engine.Restore(order(OrderSide::BUY, 99, "a")));
+    EXPECT_EQ(rejects, (std::vector<std::string>(3, "a")));
+    EXPECT_EQ(trades, 0);
+    EXPECT_EQ(engine.Resting(), 1);
+    EXPECT_EQ(engine.BestAsk(), (BookLevel<int>{100, 10, 1}));
+
+    //  the id is free again once the order leaves the book
+    engine.Cancel("a");
+    EXPECT_TRUE(engine.Sell(order(OrderSide::SELL, 101, "a")));
+    EXPECT_EQ(engine.BestAsk()->price_, 101);
+}
+
+TEST(Test_MatchingEngine, Statistics) {
+    using namespace pentifica::trd::exch;
+
+    auto callback = [](auto) {};
+    struct Config : EngineConfig {
+        using Orders = PooledOrders<16>;
+        using Keys = FixedIdKeys<16>;
+        using Stats = EngineStats<>;
+    };
+    using Engine = MatchingEngine<PoolOrder, decltype(callback), Config>;
+    auto engine{std::make_unique<Engine>(callback)};
+
+    auto order = [](OrderSide side, int price, std::size_t quantity, std::string id) {
+        return PoolOrder(side, OrderType::LIMIT, OrderTimeInForce::DAY, price, quantity, std::move(id));
+    };
+    engine->Sell(order(OrderSide::SELL, 101, 10, "s1"));
+    engine->Sell(order(OrderSide::SELL, 102, 10, "s2"));
+    engine->Sell(order(OrderSide::SELL, 103, 10, "s3"));
+    engine->Buy(order(OrderSide::BUY, 99, 10, "b1"));
+    //  reaches two levels with two fills
+    engine->Buy(order(OrderSide::BUY, 102, 15, "b2"));
+    engine->Revise(order(OrderSide::BUY, 98, 10, "b1"));
+    engine->Cancel(Engine::KeyType("s3"));
+    engine->Cancel(Engine::KeyType("unknown"));
+
+    auto const snapshot{engine->Statistics().Take()};
+    EXPECT_EQ(snapshot.Of(EngineOperation::FILL).count_, 5);
+    EXPECT_EQ(snapshot.Of(EngineOperation::REVISE).count_, 1);
+    EXPECT_EQ(snapshot.Of(EngineOperation::CANCEL).count_, 2);
+    EXPECT_EQ(snapshot.fills_, 2);
+    EXPECT_EQ(snapshot.sweeps_, 1);
+    EXPECT_EQ(snapshot.levels_swept_, 2);
+    EXPECT_EQ(snapshot.resting_, 2);
+    EXPECT_EQ(snapshot.levels_, 2);
+    EXPECT_GE(snapshot.Percentile(EngineOperation::FILL, 99), snapshot.Percentile(EngineOperation::FILL, 50));
+}
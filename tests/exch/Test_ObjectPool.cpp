@@ -0,0 +1,77 @@
+#include    <ObjectPool.h>
+
+#include    <gtest/gtest.h>
+
+#include    <memory>
+#include    <set>
+#include    <stdexcept>
+#include    <string>
+
+namespace {
+    using namespace pentifica::trd::exch;
+
+    struct Tracked {
+        explicit Tracked(std::string name, int& live) : name_{std::move(name)}, live_{live} { ++live_; }
+        ~Tracked() { --live_; }
+        std::string name_;
+        int& live_;
+    };
+}
+
+TEST(Test_ObjectPool, Initialization) {
+    ObjectPool<int> pool(8);
+    EXPECT_EQ(pool.Capacity(), 8);
+    EXPECT_EQ(pool.InUse(), 0);
+    EXPECT_THROW(ObjectPool<int>(0), std::invalid_argument);
+}
+
+TEST(Test_ObjectPool, Reuse) {
+    ObjectPool<int> pool(4);
+    std::set<int*> first;
+    for(int index = 0; index < 4; ++index) first.insert(pool.Acquire(index));
+    EXPECT_EQ(pool.InUse(), 4);
+
+    for(auto* object : first) pool.Release(object);
+    EXPECT_EQ(pool.InUse(), 0);
+
+    for(int index = 0; index < 4; ++index) {
+        EXPECT_TRUE(first.contains(pool.Acquire(index)));
+    }
+    EXPECT_EQ(pool.Capacity(), 4);
+}
+
+TEST(Test_ObjectPool, Reject) {
+    ObjectPool<int> pool(2, PoolExhaustion::REJECT);
+    auto* one = pool.Acquire(1);
+    auto* two = pool.Acquire(2);
+    EXPECT_NE(one, nullptr);
+    EXPECT_NE(two, nullptr);
+    EXPECT_EQ(pool.Acquire(3), nullptr);
+
+    pool.Release(one);
+    auto* three = pool.Acquire(3);
+    EXPECT_EQ(three, one);
+    EXPECT_EQ(*three, 3);
+    EXPECT_EQ(pool.Capacity(), 2);
+}
+
+TEST(Test_ObjectPool, Grow) {
+    ObjectPool<int> pool(2, PoolExhaustion::GROW);
+    for(int index = 0; index < 5; ++index) EXPECT_NE(pool.Acquire(index), nullptr);
+    EXPECT_EQ(pool.Capacity(), 6);
+    EXPECT_EQ(pool.InUse(), 5);
+}
+
+TEST(Test_ObjectPool, Lifetime) {
+    int live{};
+    {
+        ObjectPool<Tracked> pool(4);
+        auto* one = pool.Acquire("one", live);
+        pool.Acquire("two", live);
+        EXPECT_EQ(live, 2);
+        EXPECT_EQ(one->name_, "one");
+        pool.Release(one);
+        EXPECT_EQ(live, 1);
+    }
+    EXPECT_EQ(live, 0);
+}
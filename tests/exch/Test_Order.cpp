@@ -1,4 +1,5 @@
 #include    <Order.h>
+#include    <CompactOrder.h>
 
 #include    <gtest/gtest.h>
 
@@ -8,11 +9,15 @@ TEST(Test_Order, DefaultCtor) {
 
     TestOrder order;
     EXPECT_EQ(order.Price(), 0);
+    EXPECT_EQ(order.StopPrice(), 0);
     EXPECT_EQ(order.Quantity(), 0);
+    EXPECT_EQ(order.MaxShow(), 0);
+    EXPECT_EQ(order.MinQty(), 0);
     EXPECT_EQ(order.Side(), OrderSide::UNKNOWN);
     EXPECT_EQ(order.Type(), OrderType::UNKNOWN);
     EXPECT_EQ(order.TIF(), OrderTimeInForce::UNKNOWN);
     EXPECT_TRUE(order.Id().empty());
+    EXPECT_EQ(order.Key(), 0);
 }
 
 TEST(Test_Order, Initialization) {
@@ -82,9 +87,21 @@ TEST(Test_Order, Modify) {
     order.Price(expected_price);
     EXPECT_EQ(order.Price(), expected_price);
 
+    constexpr int expected_stop_price{25};
+    order.StopPrice(expected_stop_price);
+    EXPECT_EQ(order.StopPrice(), expected_stop_price);
+
     order.Quantity(expected_quantity);
     EXPECT_EQ(order.Quantity(), expected_quantity);
 
+    constexpr std::size_t expected_max_show{10};
+    order.MaxShow(expected_max_show);
+    EXPECT_EQ(order.MaxShow(), expected_max_show);
+
+    constexpr std::size_t expected_min_qty{50};
+    order.MinQty(expected_min_qty);
+    EXPECT_EQ(order.MinQty(), expected_min_qty);
+
     order.Side(expected_side);
     EXPECT_EQ(order.Side(), expected_side);
 
@@ -96,4 +113,43 @@ TEST(Test_Order, Modify) {
 
     order.Time(expected_time);
     EXPECT_EQ(order.Time(), expected_time);
-}
\ No newline at end of file
+
+    constexpr std::uint64_t expected_key{0x1234'5678'9abc};
+    order.Key(expected_key);
+    EXPECT_EQ(order.Key(), expected_key);
+}
+
+TEST(Test_Order, CompactOrder) {
+    using namespace pentifica::trd::exch;
+    using TestOrder = CompactOrder<double>;
+
+    static_assert(sizeof(TestOrder) == 2 * cache_line_size);
+    static_assert(alignof(TestOrder) == cache_line_size);
+    static_assert(std::is_trivially_copyable_v<TestOrder>);
+
+    TestOrder::TimePoint const expected_time{TestOrder::Clock::now()};
+    std::string const expected_id(order_id_width, 'x');
+    TestOrder order(OrderSide::SELL, OrderType::LIMIT, OrderTimeInForce::GTC, 101.5, 300,
+        expected_id, expected_time);
+    EXPECT_EQ(order.Id(), expected_id);
+    EXPECT_EQ(order.Price(), 101.5);
+    EXPECT_EQ(order.Quantity(), 300);
+    EXPECT_EQ(order.Side(), OrderSide::SELL);
+    EXPECT_EQ(order.Type(), OrderType::LIMIT);
+    EXPECT_EQ(order.TIF(), OrderTimeInForce::GTC);
+    EXPECT_EQ(order.Time(), expected_time);
+    EXPECT_TRUE(order.Account().empty());
+
+    order.Account("ACCT1");
+    order.Session("SESS1");
+    order.Quantity(100);
+    auto const copy{order};
+    EXPECT_EQ(copy.Account(), "ACCT1");
+    EXPECT_EQ(copy.Session(), "SESS1");
+    EXPECT_EQ(copy.Quantity(), 100);
+
+    EXPECT_THROW(TestOrder(OrderSide::BUY, OrderType::LIMIT, OrderTimeInForce::DAY, 1.0, 1,
+        expected_id + "x"), std::length_error);
+    EXPECT_THROW(order.Account(std::string(account_width + 1, 'a')), std::length_error);
+    EXPECT_THROW(order.Session(std::string(session_width + 1, 's')), std::length_error);
+}
@@ -0,0 +1,129 @@
+#include    <PriceLadder.h>
+
+#include    <gtest/gtest.h>
+
+#include    <functional>
+#include    <stdexcept>
+#include    <vector>
+
+namespace {
+    using namespace pentifica::trd::exch;
+
+    struct Level {
+        int orders_{};
+    };
+
+    using AskLadder = TickLadder<int, Level, std::less<int>, 128>;
+    using BidLadder = TickLadder<int, Level, std::greater<int>, 128>;
+
+    template<typename Ladder>
+    std::vector<int> Prices(Ladder const& ladder) {
+        std::vector<int> result;
+        for(auto&& [price, _] : ladder) result.push_back(price);
+        return result;
+    }
+}
+
+TEST(Test_PriceLadder, MapLadderOrder) {
+    MapLadder<int, Level, std::greater<int>> ladder;
+    EXPECT_TRUE(ladder.Empty());
+
+    for(auto price : {10, 30, 20}) ladder[price].orders_++;
+    EXPECT_EQ(ladder.BestPrice(), 30);
+    EXPECT_EQ(ladder.WorstPrice(), 10);
+    EXPECT_EQ(Prices(ladder), (std::vector<int>{30, 20, 10}));
+
+    ladder.Erase(30);
+    EXPECT_EQ(ladder.BestPrice(), 20);
+    EXPECT_EQ(ladder.Find(30), nullptr);
+    EXPECT_NE(ladder.Find(20), nullptr);
+}
+
+TEST(Test_PriceLadder, MapLadderRecycles) {
+    MapLadder<int, Level, std::less<int>> ladder;
+    for(auto price : {10, 11, 12}) ladder[price].orders_ = price;
+    auto* recycled{ladder.Find(11)};
+
+    ladder.Erase(11);
+    ladder.Erase(99);
+    EXPECT_EQ(ladder.Size(), 2);
+    EXPECT_EQ(ladder.Spare(), 1);
+
+    auto& level{ladder[15]};
+    EXPECT_EQ(&level, recycled);
+    EXPECT_EQ(level.orders_, 0);
+    EXPECT_EQ(ladder.Spare(), 0);
+    EXPECT_EQ(Prices(ladder), (std::vector<int>{10, 12, 15}));
+    EXPECT_EQ(&ladder[12], ladder.Find(12));
+}
+
+TEST(Test_PriceLadder, TickLadderAscending) {
+    AskLadder ladder;
+    EXPECT_TRUE(ladder.Empty());
+    EXPECT_TRUE(ladder.begin() == ladder.end());
+
+    for(auto price : {1005, 1001, 1070, 1003}) ladder[price].orders_++;
+    EXPECT_EQ(ladder.Size(), 4);
+    EXPECT_EQ(ladder.BestPrice(), 1001);
+    EXPECT_EQ(ladder.WorstPrice(), 1070);
+    EXPECT_EQ(Prices(ladder), (std::vector<int>{1001, 1003, 1005, 1070}));
+
+    ladder.Erase(1001);
+    EXPECT_EQ(ladder.BestPrice(), 1003);
+    ladder.Erase(1070);
+    EXPECT_EQ(ladder.WorstPrice(), 1005);
+    EXPECT_EQ(ladder.Find(1070), nullptr);
+    EXPECT_EQ(Prices(ladder), (std::vector<int>{1003, 1005}));
+}
+
+TEST(Test_PriceLadder, TickLadderDescending) {
+    BidLadder ladder;
+    for(auto price : {-3, 60, 7, 0}) ladder[price].orders_++;
+    EXPECT_EQ(ladder.BestPrice(), 60);
+    EXPECT_EQ(ladder.WorstPrice(), -3);
+    EXPECT_EQ(Prices(ladder), (std::vector<int>{60, 7, 0, -3}));
+
+    ladder.Erase(60);
+    ladder.Erase(7);
+    EXPECT_EQ(ladder.BestPrice(), 0);
+    ladder.Erase(0);
+    ladder.Erase(-3);
+    EXPECT_TRUE(ladder.Empty());
+}
+
+TEST(Test_PriceLadder, TickLadderSlidingWindow) {
+    AskLadder ladder;
+    ladder[100].orders_++;
+    EXPECT_TRUE(ladder.Accepts(227));
+    EXPECT_FALSE(ladder.Accepts(228));
+    EXPECT_THROW(ladder[228], std::out_of_range);
+
+    //  once the low end drains the window follows the market
+    ladder[200].orders_++;
+    ladder.Erase(100);
+    EXPECT_TRUE(ladder.Accepts(300));
+    ladder[300].orders_++;
+    EXPECT_EQ(Prices(ladder), (std::vector<int>{200, 300}));
+
+    //  levels are reused in place
+    auto& level = ladder[200];
+    EXPECT_EQ(level.orders_, 1);
+}
+
+TEST(Test_PriceLadder, TickLadderTickPrice) {
+    using Price = pentifica::trd::TickPrice<2>;
+    TickLadder<Price, Level, std::greater<Price>, 64> ladder;
+
+    for(auto ticks : {10010, 10050, 10030}) ladder[Price{ticks}].orders_++;
+    EXPECT_EQ(ladder.BestPrice(), Price{10050});
+    EXPECT_EQ(ladder.WorstPrice(), Price{10010});
+
+    std::vector<Price> prices;
+    for(auto&& [price, _] : ladder) prices.push_back(price);
+    EXPECT_EQ(prices, (std::vector<Price>{Price{10050}, Price{10030}, Price{10010}}));
+
+    ladder.Erase(Price{10050});
+    EXPECT_EQ(ladder.BestPrice(), Price{10030});
+    EXPECT_FALSE(ladder.Accepts(Price{10100}));
+    EXPECT_THROW(ladder[Price{10100}], std::out_of_range);
+}
@@ -0,0 +1,108 @@
+#include    <Ring.h>
+
+#include    <gtest/gtest.h>
+
+#include    <cstdint>
+#include    <thread>
+#include    <vector>
+
+namespace {
+    using namespace pentifica::trd::exch;
+}
+
+TEST(Test_Ring, SpscCapacity) {
+    SpscRing<int> ring(5);
+    EXPECT_EQ(ring.Capacity(), 8);
+
+    for(int value = 0; value < 8; ++value) EXPECT_TRUE(ring.TryPush(value));
+    EXPECT_FALSE(ring.TryPush(8));
+    EXPECT_EQ(ring.Size(), 8);
+
+    int value{};
+    EXPECT_TRUE(ring.TryPop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(ring.TryPush(8));
+}
+
+TEST(Test_Ring, SpscDrain) {
+    SpscRing<int> ring(16);
+    for(int value = 0; value < 10; ++value) ring.TryPush(value);
+
+    std::vector<int> drained;
+    auto collect = [&drained](int value) { drained.push_back(value); };
+    EXPECT_EQ(ring.Drain(collect, 4), 4);
+    EXPECT_EQ(ring.Drain(collect, 100), 6);
+    EXPECT_EQ(ring.Drain(collect, 100), 0);
+    EXPECT_EQ(drained, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(Test_Ring, SpscThreaded) {
+    constexpr std::uint64_t count{200000};
+    SpscRing<std::uint64_t> ring(1024);
+
+    std::thread producer([&ring]() {
+        for(std::uint64_t value = 1; value <= count;) {
+            if(ring.TryPush(value)) ++value;
+            else                    std::this_thread::yield();
+        }
+    });
+
+    std::uint64_t expected{1};
+    std::uint64_t sum{};
+    while(expected <= count) {
+        auto const drained{ring.Drain([&](std::uint64_t value) {
+            EXPECT_EQ(value, expected);
+            ++expected;
+            sum += value;
+        }, 64)};
+        if(drained == 0) std::this_thread::yield();
+    }
+    producer.join();
+    EXPECT_EQ(sum, count * (count + 1) / 2);
+}
+
+TEST(Test_Ring, MpscSingleThread) {
+    MpscRing<int> ring(4);
+    EXPECT_EQ(ring.Capacity(), 4);
+    for(int value = 0; value < 4; ++value) EXPECT_TRUE(ring.TryPush(value));
+    EXPECT_FALSE(ring.TryPush(4));
+
+    std::vector<int> drained;
+    EXPECT_EQ(ring.Drain([&drained](int value) { drained.push_back(value); }, 3), 3);
+    EXPECT_TRUE(ring.TryPush(4));
+
+    int value{};
+    while(ring.TryPop(value)) drained.push_back(value);
+    EXPECT_EQ(drained, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+TEST(Test_Ring, MpscThreaded) {
+    constexpr std::uint64_t producers{4};
+    constexpr std::uint64_t count{20000};
+    MpscRing<std::uint64_t> ring(256);
+
+    std::vector<std::thread> threads;
+    for(std::uint64_t producer = 0; producer < producers; ++producer) {
+        threads.emplace_back([&ring, producer]() {
+            for(std::uint64_t value = 0; value < count;) {
+                if(ring.TryPush(producer * count + value))  ++value;
+                else                                        std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<std::uint64_t> next(producers);
+    std::uint64_t received{};
+    while(received < producers * count) {
+        auto const drained{ring.Drain([&next](std::uint64_t value) {
+            auto const producer{value / count};
+            //  each producer's values arrive in the order they were pushed
+            EXPECT_EQ(value % count, next[producer]);
+            ++next[producer];
+        }, 64)};
+        if(drained == 0) std::this_thread::yield();
+        received += drained;
+    }
+    for(auto& thread : threads) thread.join();
+    for(auto value : next) EXPECT_EQ(value, count);
+}
@@ -0,0 +1,95 @@
+#include    <TimingWheel.h>
+
+#include    <gtest/gtest.h>
+
+#include    <cstdint>
+#include    <random>
+#include    <vector>
+
+namespace {
+    using namespace pentifica::trd::exch;
+
+    struct Timer : WheelLink<Timer> {
+        std::uint64_t id_{};
+    };
+    using Wheel = TimingWheel<Timer, 3, 4>;
+}
+
+TEST(Test_TimingWheel, Basic) {
+    Wheel wheel;
+    std::vector<Timer> timers(4);
+    std::uint64_t const deadlines[] = {3, 3, 20, 300};
+    for(std::size_t index = 0; index < timers.size(); ++index) {
+        timers[index].id_ = index;
+        wheel.Schedule(timers[index], deadlines[index]);
+    }
+    EXPECT_EQ(wheel.Size(), 4);
+
+    std::vector<std::uint64_t> expired;
+    auto expire = [&expired](Timer& timer) { expired.push_back(timer.id_); };
+
+    EXPECT_EQ(wheel.Advance(2, expire), 0);
+    EXPECT_EQ(wheel.Advance(3, expire), 2);
+    EXPECT_EQ(expired, (std::vector<std::uint64_t>{0, 1}));
+
+    wheel.Cancel(timers[2]);
+    wheel.Cancel(timers[2]);
+    EXPECT_EQ(wheel.Advance(100, expire), 0);
+    EXPECT_EQ(wheel.Size(), 1);
+
+    //  beyond the 4096 tick span of the wheel
+    wheel.Schedule(timers[2], 10000);
+    EXPECT_EQ(wheel.Advance(9999, expire), 1);
+    EXPECT_EQ(expired.back(), 3);
+    EXPECT_EQ(wheel.Advance(10000, expire), 1);
+    EXPECT_EQ(expired.back(), 2);
+    EXPECT_EQ(wheel.Size(), 0);
+
+    //  already due
+    wheel.Schedule(timers[0], 5);
+    EXPECT_EQ(wheel.Advance(10000, expire), 1);
+    EXPECT_EQ(wheel.Now(), 10000);
+}
+
+TEST(Test_TimingWheel, MatchesReference) {
+    Wheel wheel;
+    std::vector<Timer> timers(500);
+    std::vector<std::uint64_t> deadline(timers.size());
+    std::vector<bool> scheduled(timers.size());
+    std::mt19937_64 rng(4242);
+    std::uniform_int_distribution<std::uint64_t> delay(0, 20000);
+    std::uniform_int_distribution<std::size_t> pick(0, timers.size() - 1);
+    std::uniform_int_distribution<std::uint64_t> step(0, 300);
+
+    std::uint64_t now{};
+    auto expire = [&](Timer& timer) {
+        ASSERT_TRUE(scheduled[timer.id_]);
+        EXPECT_LE(deadline[timer.id_], now);
+        scheduled[timer.id_] = false;
+    };
+    for(std::size_t index = 0; index < timers.size(); ++index) timers[index].id_ = index;
+
+    for(int round = 0; round < 5000; ++round) {
+        auto const index{pick(rng)};
+        if(scheduled[index]) {
+            wheel.Cancel(timers[index]);
+            scheduled[index] = false;
+        }
+        else {
+            deadline[index] = now + delay(rng);
+            wheel.Schedule(timers[index], deadline[index]);
+            scheduled[index] = true;
+        }
+        now += step(rng);
+        wheel.Advance(now, expire);
+
+        //  nothing due is left behind
+        std::size_t pending{};
+        for(std::size_t check = 0; check < timers.size(); ++check) {
+            if(!scheduled[check]) continue;
+            EXPECT_GT(deadline[check], now);
+            ++pending;
+        }
+        ASSERT_EQ(wheel.Size(), pending);
+    }
+}
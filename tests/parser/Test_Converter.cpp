@@ -200,4 +200,23 @@ TEST(Test_Converter, test_string) {
         EXPECT_EQ(expected, actual);
     }
 #endif
-}
\ No newline at end of file
+}
+TEST(Test_Converter, test_tick_price) {
+    using namespace pentifica::trd;
+    using Price = TickPrice<4>;
+
+    std::vector<TestData<Price>> tests = {
+        {"0", Price{0}},
+        {"8.5", Price{85000}},
+        {"-8.439", Price{-84390}},
+        {"120.78030", Price{1207803}},
+        {"120.780399", Price{1207803}},
+        {"17", Price{170000}},
+        {"-0.0001", Price{-1}},
+    };
+
+    for(auto const& [text, expected] : tests) {
+        auto actual = translate<Price>(std::string_view(text.begin(), text.end()));
+        EXPECT_EQ(expected, actual) << text;
+    }
+}
@@ -4,6 +4,7 @@
 
 #include    <array>
 #include    <iostream>
+#include    <string>
 #include    <string_view>
 #include    <tuple>
 #include    <utility>
@@ -130,4 +131,21 @@ TEST(Test_Encode, test_append_width) {
 
     std::size_t const size = std::tuple_size<decltype(test_data)>::value;
     TestAppendWidth(test_data, std::make_index_sequence<size>{});
-}
\ No newline at end of file
+}
+TEST(Test_Encode, test_append_tick_price) {
+    using namespace pentifica::trd;
+    using namespace pentifica::trd::fix;
+
+    auto encoded = [](auto price) {
+        std::array<Byte, 256> buffer;
+        Encode message(MsgType::LOGON, Version::_4_2, buffer.begin(), buffer.end());
+        message.Append(Tag::RawData, price);
+        message.Finalize(1, 0);
+        return std::string((char*) buffer.begin(), (char*) (buffer.begin() + message.Size()));
+    };
+
+    EXPECT_NE(encoded(TickPrice<2>{3485}).find("\x01" "96=34.85\x01"), std::string::npos);
+    EXPECT_NE(encoded(TickPrice<4>{-2568}).find("\x01" "96=-0.2568\x01"), std::string::npos);
+    EXPECT_NE(encoded(TickPrice<3>{7}).find("\x01" "96=0.007\x01"), std::string::npos);
+    EXPECT_NE(encoded(TickPrice<0>{42}).find("\x01" "96=42\x01"), std::string::npos);
+}